@@ -58,6 +58,7 @@ commandLineArgs (commandLineParams)
         setUsingNativeTitleBar (false);
     
     pluginExporter.settingsToUse(cabbageSettings->getUserSettings());
+    CabbagePluginEditor::repaintCostOverlayIsEnabled = cabbageSettings->getUserSettings()->getIntValue ("ShowRepaintCost", 0) == 1;
     setColour (backgroundColourId, CabbageSettings::getColourFromValueTree (cabbageSettings->valueTree, CabbageColourIds::mainBackground, Colours::lightgrey));
     setContentOwned (content = new CabbageMainComponent (this, cabbageSettings.get()), true);
     content->propertyPanel->setVisible (false);
@@ -550,6 +551,7 @@ void CabbageDocumentWindow::createViewMenu (PopupMenu& menu)
     menu.addCommandItem(&commandManager, CommandIDs::toggleProperties);
     menu.addCommandItem(&commandManager, CommandIDs::toggleFileBrowser);
     menu.addCommandItem(&commandManager, CommandIDs::showPluginListEditor);
+    menu.addCommandItem(&commandManager, CommandIDs::showRepaintCost);
     menu.addSeparator();
     menu.addCommandItem (&commandManager, CommandIDs::zoomIn);
     menu.addCommandItem (&commandManager, CommandIDs::zoomOut);
@@ -707,6 +709,7 @@ void CabbageDocumentWindow::getAllCommands (Array <CommandID>& commands)
         CommandIDs::toggleFileBrowser,
         CommandIDs::showPluginListEditor,
         CommandIDs::autoReloadFromDisk,
+        CommandIDs::showRepaintCost,
 		CommandIDs::sendToPort,
 		CommandIDs::exportNativeUnity,
         CommandIDs::showFileMenu,
@@ -1090,6 +1093,11 @@ void CabbageDocumentWindow::getCommandInfo (CommandID commandID, ApplicationComm
             result.setTicked((autoReloadFromDisk==1 ? true : false));
             break;
             
+        case CommandIDs::showRepaintCost:
+            result.setInfo(TRANS("Show Repaint Cost"), TRANS("Show how long the plugin interface takes to paint"), "View", 0);
+            result.setTicked(CabbagePluginEditor::repaintCostOverlayIsEnabled);
+            break;
+            
         case CommandIDs::about:
             result.setInfo (TRANS ("About"), TRANS ("About."), CommandCategories::general, 0);
             break;
@@ -1519,6 +1527,14 @@ bool CabbageDocumentWindow::perform (const InvocationInfo& info)
             getContentComponent()->enableAutoUpdateMode();
             break;
             
+        case CommandIDs::showRepaintCost:
+            CabbagePluginEditor::repaintCostOverlayIsEnabled = ! CabbagePluginEditor::repaintCostOverlayIsEnabled;
+            cabbageSettings->getUserSettings()->setValue("ShowRepaintCost", CabbagePluginEditor::repaintCostOverlayIsEnabled ? 1 : 0);
+            
+            if (CabbagePluginEditor* editor = getContentComponent()->getCabbagePluginEditor())
+                editor->showRepaintCostOverlay (CabbagePluginEditor::repaintCostOverlayIsEnabled);
+            break;
+            
         case CommandIDs::editMode:
             getContentComponent()->enableEditMode();
             break;
@@ -160,6 +160,7 @@ wildcardFilter(new WildcardFileFilter("*.csd;*.sco;*.orc;*.txt;*.js;*.html;*.sna
 
 CabbageMainComponent::~CabbageMainComponent()
 {
+	fileWatcher->removeListener(this);
 	socket->shutdown();
     pluginListWindow = nullptr;
     fileTree.setLookAndFeel(nullptr);
@@ -814,7 +815,7 @@ void CabbageMainComponent::insertCustomPlantToEditor(CabbagePluginEditor* editor
     const String updatedText = CabbageWidgetData::replaceIdentifier(currentLineText, CabbageIdentifierIds::importfiles.toString(), newImportFilesIdentifierString);
     getCurrentCodeEditor()->insertCode(lineNumber, updatedText, true, true);
 
-    Range<int> cabbageSection = CabbageUtilities::getCabbageSectionRange(getCurrentCodeEditor()->getAllText());
+    Range<int> cabbageSection = getCurrentCodeEditor()->getCabbageSectionRange();
     String name;
     String namespce;
     std::unique_ptr<XmlElement> xml;
@@ -873,12 +874,19 @@ void CabbageMainComponent::updateCodeInEditor (CabbagePluginEditor* editor, bool
 {
     propertyPanel->addChangeListener (this);
 
-    if(editor->getValueTreesForCurrentlySelectedComponents().size()>0)
+    const Array<ValueTree> selectedWidgets = editor->getValueTreesForCurrentlySelectedComponents();
+
+    if(selectedWidgets.size()>0)
     {
-        for (ValueTree wData : editor->getValueTreesForCurrentlySelectedComponents())
+        CabbageCodeEditorComponent* codeEditor = getCurrentCodeEditor();
+        //the code editor keeps track of the Cabbage section, and every widget's line goes into one edit
+        const Range<int> cabbageSection = codeEditor->getCabbageSectionRange();
+        Array<CabbageCodeEditorComponent::LineEdit> edits;
+        int lineToHighlight = -1;
+
+        for (ValueTree wData : selectedWidgets)
         {
             int lineNumber = 0;
-            Range<int> cabbageSection = CabbageUtilities::getCabbageSectionRange(getCurrentCodeEditor()->getAllText());
 
             if (CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::linenumber) >= 1 && CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::surrogatelinenumber)<=0)
             {
@@ -889,26 +897,38 @@ void CabbageMainComponent::updateCodeInEditor (CabbagePluginEditor* editor, bool
                 
                 lineNumber = jmin(cabbageSection.getEnd(),
                                   int(CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::linenumber)));
-                const String type = CabbageWidgetData::getStringProp(wData, CabbageIdentifierIds::type);
 
                 const String parent = CabbageWidgetData::getStringProp(wData,
                                                                        CabbageIdentifierIds::parentcomponent); // if widget has a parent don't highlight line
 
-                const String currentLineText = getCurrentCodeEditor()->getLineText(lineNumber);
+                const String currentLineText = codeEditor->getLineText(lineNumber);
+
+                const bool isBoundsUpdate = isGUIEnabled == true && guiPropUpdate == false;
+
+                //moving and resizing only changes bounds(), there's no need to regenerate the rest of the line
+                if (isBoundsUpdate && currentLineText.contains("bounds("))
+                {
+                    const String newBounds = CabbageWidgetData::getBoundsTextAsCabbageCode(CabbageWidgetData::getBounds(wData));
+                    edits.add({ lineNumber, CabbageWidgetData::replaceIdentifier(currentLineText, "bounds(", newBounds), true });
+                    lineToHighlight = lineNumber;
+                    continue;
+                }
 
                 const String newText = CabbageWidgetData::getStringProp(wData, "precedingCharacters")
                                        + CabbageWidgetData::getCabbageCodeFromIdentifiers(wData, (currentLineText ==
                                                                                                   "</Cabbage>" ? ""
                                                                                                                : currentLineText));
 
-                if (isGUIEnabled == true && guiPropUpdate == false)
-                    getCurrentCodeEditor()->updateBoundsText(lineNumber, newText, true);
-                else
-                    getCurrentCodeEditor()->insertCode(lineNumber, newText, replaceExistingLine, parent.isEmpty());
+                //a widget without bounds() on its line, such as one just added in edit mode, goes in as a new line
+                edits.add({ lineNumber, newText, isBoundsUpdate ? false : replaceExistingLine });
 
+                if (isBoundsUpdate || parent.isEmpty())
+                    lineToHighlight = lineNumber;
             }
 
         }
+
+        codeEditor->applyLineEdits(edits, lineToHighlight);
     }
     else
     {
@@ -938,20 +958,6 @@ void CabbageMainComponent::timerCallback()
 
         }
         
-        if(cabbageSettings->getUserSettings()->getIntValue("AutoReloadFromDisk")){
-            const auto originalFileIndex = getCurrentFileIndex();
-            for ( int i = 0 ; i < fileTabs.size() ; i++)
-            {
-                if(fileTabs[i]->lastModified != fileTabs[i]->getFile().getLastModificationTime())
-                {
-                    currentFileIndex = i;
-                    getCurrentEditorContainer()->editor->loadContent(fileTabs[i]->getFile().loadFileAsString());
-                    saveDocument();
-                }
-            }
-            currentFileIndex = originalFileIndex;
-        }
-        
 //        
 //        saveDocument(false, true);
 //        DBG("Number of compilations:"+String(compileCounter++));
@@ -1043,6 +1049,59 @@ void CabbageMainComponent::addFileTab (File file)
 
 
     arrangeFileTabs();
+    updateWatchedFiles();
+}
+
+//==============================================================================
+void CabbageMainComponent::updateWatchedFiles()
+{
+    Array<File> files;
+
+    for (auto* tab : fileTabs)
+        CabbageFileWatcher::addFileAndIncludes(tab->getFile(), files);
+
+    fileWatcher->setWatchedFiles(this, files);
+}
+
+void CabbageMainComponent::watchedFilesChanged(const Array<File>& changedFiles)
+{
+    if (!cabbageSettings->getUserSettings()->getIntValue("AutoReloadFromDisk"))
+        return;
+
+    for (int i = 0; i < fileTabs.size() && i < editorAndConsole.size(); i++)
+    {
+        const File file = fileTabs[i]->getFile();
+        bool needsRecompile = false;
+
+        if (changedFiles.contains(file))
+        {
+            //our own saves come through here too, only pick up text the editor doesn't have yet
+            const String text = file.loadFileAsString();
+
+            if (file.existsAsFile() && text != editorAndConsole[i]->editor->getAllText())
+            {
+                editorAndConsole[i]->editor->loadContent(text);
+                editorAndConsole[i]->editor->setSavePoint();
+                needsRecompile = true;
+            }
+        }
+        else
+        {
+            Array<File> dependencies;
+            CabbageFileWatcher::addFileAndIncludes(file, dependencies);
+
+            for (const auto& changedFile : changedFiles)
+                needsRecompile = needsRecompile || dependencies.contains(changedFile);
+        }
+
+        fileTabs[i]->lastModified = file.getLastModificationTime();
+
+        //only instruments that are already running get recompiled
+        if (needsRecompile && fileTabs[i]->getPlayButton().getToggleState() && file.hasFileExtension(".csd"))
+            runCsoundForNode(file.getFullPathName(), i);
+    }
+
+    updateWatchedFiles();
 }
 
 void CabbageMainComponent::arrangeFileTabs()
@@ -1136,11 +1195,12 @@ void CabbageMainComponent::showPluginListEditor()
     pluginListWindow->toFront (true);
 }
 //==============================================================================
-void CabbageMainComponent::createEditorForFilterGraphNode (juce::Point<int> position)
+void CabbageMainComponent::createEditorForFilterGraphNode (juce::Point<int> position, int fileTabIndex)
 {
 
     String pluginName = "";
-    AudioProcessorGraph::NodeID nodeId(fileTabs[currentFileIndex]->uniqueFileId);
+    const int tabIndex = fileTabIndex != -99 ? fileTabIndex : currentFileIndex;
+    AudioProcessorGraph::NodeID nodeId(fileTabs[tabIndex]->uniqueFileId);
 
 	
     if (AudioProcessorGraph::Node::Ptr f = getFilterGraph()->graph.getNodeForId (nodeId))
@@ -1156,8 +1216,20 @@ void CabbageMainComponent::createEditorForFilterGraphNode (juce::Point<int> posi
             {
                 String time = Time::getCurrentTime().formatted("_%Y%m%d_%H%M%S");
                 File documentDir = File::getSpecialLocation(File::SpecialLocationType::userDocumentsDirectory);
-                String filename = documentDir.getChildFile((getCurrentCsdFile().getFileNameWithoutExtension()+time+".wav")).getFullPathName();
-                cabbagePlugin->startRecording(filename, bitDepth);
+                String filename = documentDir.getChildFile((fileTabs[tabIndex]->getFile().getFileNameWithoutExtension()+time+".wav")).getFullPathName();
+
+                CabbageAudioRecorder::Options options;
+                options.file = File (filename);
+                options.bitDepth = bitDepth;
+                options.format = cabbageSettings->getUserSettings()->getValue ("RecordingFormat").equalsIgnoreCase ("flac") ? CabbageAudioRecorder::Format::flac
+                                                                                                                           : CabbageAudioRecorder::Format::wav;
+                //"buses" adds a file per output bus, anything else is taken as a Csound audio channel
+                StringArray stems = StringArray::fromTokens (cabbageSettings->getUserSettings()->getValue ("RecordingStems"), ", ", "\"");
+                stems.removeEmptyStrings();
+                options.recordOutputBuses = stems.contains ("buses");
+                stems.removeString ("buses");
+                options.csoundChannels = stems;
+                cabbagePlugin->startRecording (options);
                 factory.startRecordingTimer(false);
             }
         }
@@ -1844,6 +1916,8 @@ void CabbageMainComponent::saveDocument (bool saveAs, bool compileFromPlayButton
 
 			addInstrumentsAndRegionsToCombobox();
 			getCurrentCodeEditor()->setSavePoint();
+            //a save can add or remove #includes
+            updateWatchedFiles();
 		}
 
 		StringArray lines;
@@ -1937,7 +2011,7 @@ void CabbageMainComponent::removeEditor()
         cabbageSettings->setProperty ("MostRecentFile", fileTabs[currentFileIndex]->getFile().getFullPathName());
     }
 
-
+    updateWatchedFiles();
     repaint();
 
 
@@ -2006,36 +2080,23 @@ int CabbageMainComponent::sendToPort()
 
 //==================================================================================
 
-int CabbageMainComponent::testFileForErrors (String file)
+bool CabbageMainComponent::reportValidationErrors (const String& file, const CabbageValidationResult& result)
 {
-    //this method will start a Csound process and test it for i-time errors and possible infinite loops.
-    //It only runs 16 k-cycles, so it will not be able to detect perf-time hangs
-    ChildProcess process;
-    const String applicationDir = File::getSpecialLocation (File::currentExecutableFile).getParentDirectory().getFullPathName();
-    const String processName = applicationDir + "/CabbageCsoundCLI";
-
-    if (File (processName).existsAsFile())
-    {
-        const String output = process.readAllProcessOutput();
-
-        process.start (processName + " " + file);
-        process.waitForProcessToFinish(400);
-
-        const int exitCode = process.getExitCode();
+    //compile errors are left for the running instrument to report, only crashes and hangs stop it from starting
+    if (result.isSafeToRun())
+        return false;
 
-        if (exitCode == 1)
-        {
-            process.start ("csound " + file);
-            this->getCurrentOutputConsole()->setText (process.readAllProcessOutput());
-            stopCsoundForNode (file);
-            return 1;
-        }
+    String report = result.output;
 
-        process.kill();
-    }
-
-    return 0;
+    if (result.timedOut)
+        report << "\nCabbage: " << File (file).getFileName() << " didn't finish its trial run within "
+               << CabbageValidationService::timeoutMs / 1000 << " seconds and has not been started.\n";
+    else
+        report << "\nCabbage: " << File (file).getFileName() << " crashed Csound and has not been started.\n" << result.crashReport;
 
+    this->getCurrentOutputConsole()->setText (report);
+    stopCsoundForNode (file);
+    return true;
 }
 
 void CabbageMainComponent::covertToLowerCase()
@@ -2126,77 +2187,116 @@ void CabbageMainComponent::covertToCamelCase()
 void CabbageMainComponent::runCsoundForNode (String file, int fileTabIndex)
 {
     startFilterGraph();
-    if (testFileForErrors (file) == 0) //if Csound seg faults it will take Cabbage down. best to test the instrument in a separate process first.
+
+    double sampleRate = 44100;
+    int blockSize = 512;
+
+    if (auto* device = deviceManager.getCurrentAudioDevice())
     {
-        if (File (file).existsAsFile())
-        {
+        sampleRate = device->getCurrentSampleRate();
+        blockSize = device->getCurrentBufferSizeSamples();
+    }
 
-            StringArray warnings = preCompileCheckForIssues(File(file));
+    //the tab is picked now, the user can switch, close or open tabs while the worker is busy
+    const int tabIndex = fileTabIndex != -99 ? fileTabIndex : currentFileIndex;
 
-            AudioProcessorGraph::NodeID node(fileTabs[fileTabIndex != -99 ? fileTabIndex : currentFileIndex]->uniqueFileId);
+    if (! isPositiveAndBelow (tabIndex, fileTabs.size()))
+        return;
 
-            if (node.uid == -99)
-            {
-                Uuid uniqueID;
-                node.uid = int32(*uniqueID.getRawData());
-                fileTabs[fileTabIndex != -99 ? fileTabIndex : currentFileIndex]->uniqueFileId = node.uid;
-            }
+    //if Csound seg faults it will take Cabbage down, so the instrument is tried out in the validation worker first.
+    //The worker answers asynchronously, the UI carries on in the meantime
+    Component::SafePointer<CabbageMainComponent> safeThis (this);
+    Component::SafePointer<FileTab> fileTab (fileTabs[tabIndex]);
 
-            Random rand;
-            double posOffset = rand.nextDouble() * 0.2;
-            juce::Point<double> pluginNodePos(.5 + posOffset, .5 + posOffset);
-            juce::Point<int> pluginWindowPos(-1000, -1000);
+    validationService.validate (File (file), sampleRate, blockSize, [safeThis, fileTab, file] (const CabbageValidationResult& result)
+    {
+        if (safeThis == nullptr || safeThis->reportValidationErrors (file, result))
+            return;
 
+        //the tab may have been closed or moved while the worker was busy
+        const int index = safeThis->fileTabs.indexOf (fileTab.getComponent());
 
-            if (getFilterGraph()->graph.getNodeForId(node))
-            {
-                pluginNodePos = juce::Point<double>(getFilterGraph()->graph.getNodeForId(node)->properties.getWithDefault("x", rand.nextDouble()),
-                    getFilterGraph()->graph.getNodeForId(node)->properties.getWithDefault("y", rand.nextDouble()));
+        if (index < 0)
+            return;
 
-                pluginWindowPos = juce::Point<int>(getFilterGraph()->graph.getNodeForId(node)->properties.getWithDefault("PluginWindowX", rand.nextInt(Range<int>(0, 500))),
-                    getFilterGraph()->graph.getNodeForId(node)->properties.getWithDefault("PluginWindowY", rand.nextInt(Range<int>(0, 500))));
+        safeThis->startCsoundForNode (file, index);
+    });
+}
 
-            }
+void CabbageMainComponent::startCsoundForNode (String file, int fileTabIndex)
+{
+    if (File (file).existsAsFile())
+    {
 
+        StringArray warnings = preCompileCheckForIssues(File(file));
 
+        //background tabs are recompiled when their includes change, so nothing here can assume the visible tab
+        const int tabIndex = fileTabIndex != -99 ? fileTabIndex : currentFileIndex;
 
+        AudioProcessorGraph::NodeID node(fileTabs[tabIndex]->uniqueFileId);
 
-            //getCurrentCsdFile().getParentDirectory().setAsCurrentWorkingDirectory();
-            //this will create or update plugin...
-            this->getCurrentOutputConsole()->setText("\n/*============================================================*/\n");
-            graphComponent->createNewPlugin(FilterGraph::getPluginDescriptor(node, getCurrentCsdFile().getFullPathName()), pluginNodePos);
+        if (node.uid == -99)
+        {
+            Uuid uniqueID;
+            node.uid = int32(*uniqueID.getRawData());
+            fileTabs[tabIndex]->uniqueFileId = node.uid;
+        }
 
+        Random rand;
+        double posOffset = rand.nextDouble() * 0.2;
+        juce::Point<double> pluginNodePos(.5 + posOffset, .5 + posOffset);
+        juce::Point<int> pluginWindowPos(-1000, -1000);
 
-            createEditorForFilterGraphNode(pluginWindowPos);
 
-            startTimer(500);
-            if (getFilterGraph()->graph.getNodeForId(node))
-            {
-                fileTabs[fileTabIndex != -99 ? fileTabIndex : currentFileIndex]->getPlayButton().getProperties().set("state", "on");
-                fileTabs[fileTabIndex != -99 ? fileTabIndex : currentFileIndex]->getPlayButton().setToggleState(true, dontSendNotification);
-            }
-            else
-            {
-                fileTabs[fileTabIndex != -99 ? fileTabIndex : currentFileIndex]->getPlayButton().getProperties().set("state", "on");
-                fileTabs[fileTabIndex != -99 ? fileTabIndex : currentFileIndex]->getPlayButton().setToggleState(false, dontSendNotification);
-            }
+        if (getFilterGraph()->graph.getNodeForId(node))
+        {
+            pluginNodePos = juce::Point<double>(getFilterGraph()->graph.getNodeForId(node)->properties.getWithDefault("x", rand.nextDouble()),
+                getFilterGraph()->graph.getNodeForId(node)->properties.getWithDefault("y", rand.nextDouble()));
 
-            factory.togglePlay(true);
-            factory.setRecordButtonState("disabled");
-            //hack to allow saving on the fly with JUCE 5.4.7 - needs investigation...
+            pluginWindowPos = juce::Point<int>(getFilterGraph()->graph.getNodeForId(node)->properties.getWithDefault("PluginWindowX", rand.nextInt(Range<int>(0, 500))),
+                getFilterGraph()->graph.getNodeForId(node)->properties.getWithDefault("PluginWindowY", rand.nextInt(Range<int>(0, 500))));
 
-            graphComponent->enableAudioInput();
-            
-            if(warnings.size()>0)
-            {
-                Timer::callAfterDelay(1000, [warnings, this](){
-                    this->getCurrentOutputConsole()->setText("/*"+ warnings.joinIntoString("\n") + "\n*/\n");
-                });
-            }
+        }
+
+
+
+
+        //getCurrentCsdFile().getParentDirectory().setAsCurrentWorkingDirectory();
+        //this will create or update plugin...
+        editorAndConsole[tabIndex]->outputConsole->setText("\n/*============================================================*/\n");
+        graphComponent->createNewPlugin(FilterGraph::getPluginDescriptor(node, file), pluginNodePos);
+
+
+        createEditorForFilterGraphNode(pluginWindowPos, tabIndex);
+
+        startTimer(500);
+        if (getFilterGraph()->graph.getNodeForId(node))
+        {
+            fileTabs[tabIndex]->getPlayButton().getProperties().set("state", "on");
+            fileTabs[tabIndex]->getPlayButton().setToggleState(true, dontSendNotification);
         }
         else
-        CabbageUtilities::showMessage("Warning", "Please open a file first", lookAndFeel.get());
+        {
+            fileTabs[tabIndex]->getPlayButton().getProperties().set("state", "on");
+            fileTabs[tabIndex]->getPlayButton().setToggleState(false, dontSendNotification);
+        }
+
+        factory.togglePlay(true);
+        factory.setRecordButtonState("disabled");
+        //hack to allow saving on the fly with JUCE 5.4.7 - needs investigation...
+
+        graphComponent->enableAudioInput();
+        
+        if(warnings.size()>0)
+        {
+            Timer::callAfterDelay(1000, [warnings, this, tabIndex](){
+                if (isPositiveAndBelow(tabIndex, editorAndConsole.size()))
+                    editorAndConsole[tabIndex]->outputConsole->setText("/*"+ warnings.joinIntoString("\n") + "\n*/\n");
+            });
+        }
     }
+    else
+    CabbageUtilities::showMessage("Warning", "Please open a file first", lookAndFeel.get());
 }
 
 StringArray CabbageMainComponent::preCompileCheckForIssues(File file)
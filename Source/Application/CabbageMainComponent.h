@@ -38,6 +38,8 @@
 #include "../Audio/Plugins/GenericCabbagePluginProcessor.h"
 #include "../Audio/Plugins/CabbageInternalPluginFormat.h"
 #include "../Utilities/CabbagePluginList.h"
+#include "../Utilities/CabbageFileWatcher.h"
+#include "CabbageValidationWorker.h"
 
 class CabbageDocumentWindow;
 class FileTab;
@@ -52,7 +54,8 @@ class CabbageMainComponent
 	public Timer,
 	public ComboBox::Listener,
 	public FileDragAndDropTarget,
-	public FileBrowserListener
+	public FileBrowserListener,
+	private CabbageFileWatcher::Listener
 {
 public:
 
@@ -76,7 +79,7 @@ public:
 	void paint(Graphics&) override;
 	void resized() override;
 	void resizeAllWindows(int height);
-	void createEditorForFilterGraphNode(juce::Point<int> position);
+	void createEditorForFilterGraphNode(juce::Point<int> position, int fileTabIndex = -99);
 	void createFilterGraph();
 	void createCodeEditorForFile(File file);
 	void createNewProject();
@@ -114,7 +117,7 @@ public:
 	File getCurrentCsdFile();
 	void setCurrentCsdFile(File file);
 	void writeFileToDisk(File file);
-	int testFileForErrors(String file);
+	bool reportValidationErrors(const String& file, const CabbageValidationResult& result);
 	int getCurrentFileIndex() { return currentFileIndex; }
 	//==============================================================================
 	void handleToolbarButtons(ToolbarButton* toolbarButton);
@@ -297,6 +300,13 @@ private:
 
     GraphDocumentComponent* graphComponent = nullptr;
     std::unique_ptr<FilterGraphDocumentWindow> filterGraphWindow;
+    CabbageValidationService validationService;
+    void startCsoundForNode(String file, int fileTabIndex);
+
+    //each tab's file and whatever it #includes, for AutoReloadFromDisk
+    void updateWatchedFiles();
+    void watchedFilesChanged(const Array<File>& changedFiles) override;
+    SharedResourcePointer<CabbageFileWatcher> fileWatcher;
 
 
     //std::unique_ptr<HtmlHelpDocumentWindow> helpWindow;
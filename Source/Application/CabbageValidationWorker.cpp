@@ -0,0 +1,300 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CabbageValidationWorker.h"
+#include "../Audio/Plugins/CabbagePluginProcessor.h"
+#include "../Audio/Plugins/GenericCabbagePluginProcessor.h"
+#include <fstream>
+
+namespace
+{
+    //where the worker's crash handler writes a backtrace, set with each request
+    File workerCrashReportFile;
+
+    void writeCrashReport (void*)
+    {
+        std::ofstream file (workerCrashReportFile.getFullPathName().toStdString());
+        file << SystemStats::getStackBacktrace();
+    }
+
+    MemoryBlock toMessage (const var& v)
+    {
+        const String json = JSON::toString (v, true);
+        return MemoryBlock (json.toRawUTF8(), json.getNumBytesAsUTF8());
+    }
+
+    var fromMessage (const MemoryBlock& message)
+    {
+        return JSON::parse (message.toString());
+    }
+}
+
+//==============================================================================
+var CabbageValidationResult::toVar() const
+{
+    DynamicObject::Ptr object (new DynamicObject());
+    object->setProperty ("compiled", compiled);
+    object->setProperty ("crashed", crashed);
+    object->setProperty ("timedOut", timedOut);
+    object->setProperty ("kCyclesPerformed", kCyclesPerformed);
+    object->setProperty ("kCyclesPerSecond", kCyclesPerSecond);
+    object->setProperty ("realtimeRatio", realtimeRatio);
+    object->setProperty ("errors", errors.joinIntoString ("\n"));
+    object->setProperty ("output", output);
+    object->setProperty ("crashReport", crashReport);
+    return var (object.get());
+}
+
+CabbageValidationResult CabbageValidationResult::fromVar (const var& v)
+{
+    CabbageValidationResult result;
+    result.compiled = v.getProperty ("compiled", false);
+    result.crashed = v.getProperty ("crashed", false);
+    result.timedOut = v.getProperty ("timedOut", false);
+    result.kCyclesPerformed = v.getProperty ("kCyclesPerformed", 0);
+    result.kCyclesPerSecond = v.getProperty ("kCyclesPerSecond", 0);
+    result.realtimeRatio = v.getProperty ("realtimeRatio", 0);
+    result.errors.addLines (v.getProperty ("errors", "").toString());
+    result.errors.removeEmptyStrings();
+    result.output = v.getProperty ("output", "").toString();
+    result.crashReport = v.getProperty ("crashReport", "").toString();
+    return result;
+}
+
+//==============================================================================
+void CabbageValidationWorker::handleMessageFromMaster (const MemoryBlock& message)
+{
+    const var request = fromMessage (message);
+    const int id = request.getProperty ("id", -1);
+    const File csdFile (request.getProperty ("csd", "").toString());
+    const double sampleRate = request.getProperty ("sampleRate", 44100.0);
+    const int blockSize = request.getProperty ("blockSize", 512);
+    workerCrashReportFile = File (request.getProperty ("crashReportFile", "").toString());
+
+    //processors expect to be created and driven from the message thread
+    MessageManager::callAsync ([this, id, csdFile, sampleRate, blockSize]
+    {
+        const var result = validate (csdFile, sampleRate, blockSize).toVar();
+        result.getDynamicObject()->setProperty ("id", id);
+        sendMessageToMaster (toMessage (result));
+    });
+}
+
+void CabbageValidationWorker::handleConnectionLost()
+{
+    //the IDE has gone, so there's nothing left to do
+    MessageManager::callAsync ([] { JUCEApplicationBase::quit(); });
+}
+
+CabbageValidationResult CabbageValidationWorker::validate (const File& csdFile, double sampleRate, int blockSize)
+{
+    //the old command line checker only ran 16 k-cycles, a quarter of a second is enough to time as well
+    const double maxSecondsToRun = 0.25;
+
+    CabbageValidationResult result;
+    SystemStats::setApplicationCrashHandler (writeCrashReport);
+
+    if (! csdFile.existsAsFile() || sampleRate <= 0 || blockSize <= 0)
+    {
+        result.errors.add ("Couldn't open " + csdFile.getFullPathName());
+        return result;
+    }
+
+    std::unique_ptr<CsoundPluginProcessor> processor;
+
+    if (csdFile.loadFileAsString().contains ("<Cabbage>"))
+        processor.reset (new CabbagePluginProcessor (csdFile, CabbagePluginProcessor::readBusesPropertiesFromXml (csdFile)));
+    else
+        processor.reset (new GenericCabbagePluginProcessor (csdFile, CabbagePluginProcessor::readBusesPropertiesFromXml (csdFile)));
+
+    processor->setRateAndBufferSizeDetails (sampleRate, blockSize);
+    processor->prepareToPlay (sampleRate, blockSize);
+    result.compiled = processor->csdCompiledWithoutError();
+
+    if (result.compiled)
+    {
+        AudioBuffer<float> buffer (jmax (1, processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels()), blockSize);
+        MidiBuffer midiMessages;
+        int64 numSamplesProcessed = 0;
+        const double startTime = Time::getMillisecondCounterHiRes();
+        double elapsedSeconds = 0;
+
+        while (elapsedSeconds < maxSecondsToRun && numSamplesProcessed < int64 (sampleRate * maxSecondsToRun * 16))
+        {
+            buffer.clear();
+            midiMessages.clear();
+            processor->processBlock (buffer, midiMessages);
+            numSamplesProcessed += blockSize;
+            elapsedSeconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+        }
+
+        if (auto* csound = processor->getCsound())
+        {
+            //ksmps counts samples at Csound's rate, which is higher than the host's when oversampling
+            const double csoundSamples = double (numSamplesProcessed) * csound->GetSr() / sampleRate;
+            result.kCyclesPerformed = int (csoundSamples / jmax (1, (int) csound->GetKsmps()));
+        }
+
+        result.kCyclesPerSecond = elapsedSeconds > 0 ? result.kCyclesPerformed / elapsedSeconds : 0;
+        result.realtimeRatio = elapsedSeconds > 0 ? (double (numSamplesProcessed) / sampleRate) / elapsedSeconds : 0;
+    }
+
+    //Csound's output reaches the processor through its log thread, give that a moment to catch up
+    int lastVersionSeen = -1;
+
+    for (int i = 0; i < 20; i++)
+    {
+        if (! processor->getCsoundOutputSnapshot (result.output, lastVersionSeen) && i > 1)
+            break;
+
+        Thread::sleep (25);
+    }
+
+    for (const auto& line : StringArray::fromLines (result.output))
+        if (line.containsIgnoreCase ("error"))
+            result.errors.add (line.trim());
+
+    return result;
+}
+
+//==============================================================================
+CabbageValidationService::~CabbageValidationService()
+{
+    stopTimer();
+    killSlaveProcess();
+    crashReportFile.deleteFile();
+}
+
+void CabbageValidationService::validate (const File& csdFile, double sampleRate, int blockSize, Callback callback)
+{
+    requests.push_back ({ nextRequestId++, csdFile, sampleRate, blockSize, std::move (callback) });
+
+    if (! waitingForWorker)
+        sendNextRequest();
+}
+
+bool CabbageValidationService::launchWorker()
+{
+    if (workerIsRunning)
+        return true;
+
+    if (crashReportFile == File())
+        crashReportFile = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("CabbageValidationCrash", ".txt", false);
+
+    workerIsRunning = launchSlaveProcess (File::getSpecialLocation (File::currentExecutableFile), CabbageValidationWorker::commandLineUID);
+    return workerIsRunning;
+}
+
+void CabbageValidationService::sendNextRequest()
+{
+    if (! requests.empty() && ! waitingForWorker)
+    {
+        const auto& request = requests.front();
+
+        DynamicObject::Ptr message (new DynamicObject());
+        message->setProperty ("id", request.id);
+        message->setProperty ("csd", request.csdFile.getFullPathName());
+        message->setProperty ("sampleRate", request.sampleRate);
+        message->setProperty ("blockSize", request.blockSize);
+        message->setProperty ("crashReportFile", crashReportFile.getFullPathName());
+        crashReportFile.deleteFile();
+
+        if (launchWorker() && sendMessageToSlave (toMessage (var (message.get()))))
+        {
+            waitingForWorker = true;
+            requestStartTime = Time::getMillisecondCounter();
+            startTimer (250);
+        }
+        else
+        {
+            //without a worker, behave as Cabbage did when the command line checker was missing
+            abandonWorker (false);
+            finishCurrentRequest ({});
+        }
+    }
+}
+
+void CabbageValidationService::finishCurrentRequest (const CabbageValidationResult& result)
+{
+    if (requests.empty())
+        return;
+
+    auto callback = std::move (requests.front().callback);
+    requests.pop_front();
+    waitingForWorker = false;
+    stopTimer();
+
+    if (callback)
+        callback (result);
+
+    sendNextRequest();
+}
+
+void CabbageValidationService::abandonWorker (bool timedOut)
+{
+    killSlaveProcess();
+    workerIsRunning = false;
+    ++workerGeneration;
+
+    if (waitingForWorker)
+    {
+        CabbageValidationResult result;
+        result.crashed = ! timedOut;
+        result.timedOut = timedOut;
+        result.crashReport = crashReportFile.loadFileAsString();
+        finishCurrentRequest (result);
+    }
+}
+
+void CabbageValidationService::handleMessageFromSlave (const MemoryBlock& message)
+{
+    const var result = fromMessage (message);
+    WeakReference<CabbageValidationService> weakThis (this);
+
+    MessageManager::callAsync ([weakThis, result]
+    {
+        if (weakThis == nullptr || ! weakThis->waitingForWorker || weakThis->requests.empty())
+            return;
+
+        //a reply to a request that has already been given up on
+        if (int (result.getProperty ("id", -1)) != weakThis->requests.front().id)
+            return;
+
+        weakThis->finishCurrentRequest (CabbageValidationResult::fromVar (result));
+    });
+}
+
+void CabbageValidationService::handleConnectionLost()
+{
+    WeakReference<CabbageValidationService> weakThis (this);
+    const int generation = workerGeneration;
+
+    MessageManager::callAsync ([weakThis, generation]
+    {
+        //the next request starts a new worker
+        if (weakThis != nullptr && weakThis->workerIsRunning && weakThis->workerGeneration == generation)
+            weakThis->abandonWorker (false);
+    });
+}
+
+void CabbageValidationService::timerCallback()
+{
+    if (waitingForWorker && Time::getMillisecondCounter() - requestStartTime > (uint32) timeoutMs)
+        abandonWorker (true);
+}
@@ -0,0 +1,112 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEVALIDATIONWORKER_H_INCLUDED
+#define CABBAGEVALIDATIONWORKER_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <deque>
+
+//==============================================================================
+// What came back from trying a csd out in the validation worker.
+//==============================================================================
+struct CabbageValidationResult
+{
+    bool compiled = false;
+    bool crashed = false;               //the worker went down while running it
+    bool timedOut = false;              //an i-time or perf-time loop that never returned
+    int kCyclesPerformed = 0;
+    double kCyclesPerSecond = 0;
+    double realtimeRatio = 0;           //how many times faster than real time it ran
+    StringArray errors;
+    String output, crashReport;
+
+    bool isSafeToRun() const    {   return ! crashed && ! timedOut;   }
+
+    var toVar() const;
+    static CabbageValidationResult fromVar (const var& v);
+};
+
+//==============================================================================
+// Runs in a second copy of the Cabbage executable, started with the worker
+// command line. It keeps Csound and its opcode libraries loaded between
+// requests. For each csd it builds the same processor the IDE would, then
+// performs a few hundred milliseconds of audio with it and sends back what
+// happened. If Csound takes the process down, the IDE side notices the lost
+// connection and starts a fresh worker.
+//==============================================================================
+class CabbageValidationWorker : public ChildProcessSlave
+{
+public:
+    static constexpr const char* commandLineUID = "cabbageValidationWorker";
+
+    void handleMessageFromMaster (const MemoryBlock& message) override;
+    void handleConnectionLost() override;
+
+private:
+    static CabbageValidationResult validate (const File& csdFile, double sampleRate, int blockSize);
+};
+
+//==============================================================================
+// The IDE's end of the worker. Requests are queued and sent one at a time,
+// and results are delivered on the message thread, so nothing waits on the
+// worker. A worker that stops answering is killed and relaunched.
+//==============================================================================
+class CabbageValidationService : private ChildProcessMaster, private Timer
+{
+public:
+    using Callback = std::function<void (const CabbageValidationResult&)>;
+
+    static constexpr int timeoutMs = 5000;
+
+    ~CabbageValidationService() override;
+
+    //the callback is always called, straight away with a default result if there's no worker to ask
+    void validate (const File& csdFile, double sampleRate, int blockSize, Callback callback);
+
+private:
+    struct Request
+    {
+        int id;
+        File csdFile;
+        double sampleRate;
+        int blockSize;
+        Callback callback;
+    };
+
+    void handleMessageFromSlave (const MemoryBlock& message) override;
+    void handleConnectionLost() override;
+    void timerCallback() override;
+
+    bool launchWorker();
+    void sendNextRequest();
+    void finishCurrentRequest (const CabbageValidationResult& result);
+    void abandonWorker (bool timedOut);
+
+    std::deque<Request> requests;       //the front one is with the worker when waitingForWorker is set
+    bool waitingForWorker = false, workerIsRunning = false;
+    int nextRequestId = 0;
+    std::atomic<int> workerGeneration { 0 };  //so a lost connection isn't blamed on the worker that replaced it
+    uint32 requestStartTime = 0;
+    File crashReportFile;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (CabbageValidationService)
+};
+
+#endif  // CABBAGEVALIDATIONWORKER_H_INCLUDED
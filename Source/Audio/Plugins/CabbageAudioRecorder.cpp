@@ -0,0 +1,234 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CabbageAudioRecorder.h"
+
+//==============================================================================
+CabbageAudioRecorder::~CabbageAudioRecorder()
+{
+    stop();
+    thread.stopThread (4000);
+}
+
+bool CabbageAudioRecorder::arm (const Options& options, const Array<StemSource>& sources, double sampleRate)
+{
+    stop();
+
+    if (sampleRate <= 0 || sources.isEmpty())
+        return false;
+
+    const File mainFile = options.file.withFileExtension (options.format == Format::flac ? ".flac" : ".wav");
+    auto newSession = std::make_unique<Session>();
+
+    for (const auto& source : sources)
+    {
+        const File file = source.name.isEmpty() ? mainFile
+                                                : mainFile.getSiblingFile (mainFile.getFileNameWithoutExtension() + "_" + File::createLegalFileName (source.name) + mainFile.getFileExtension());
+
+        const double stemSampleRate = source.sampleRate > 0 ? source.sampleRate : sampleRate;
+
+        //a couple of seconds gives the disk plenty of slack before anything is dropped
+        const int fifoSize = jmax (32768, roundToInt (stemSampleRate * 2.0));
+        const int preRollSize = jmax (0, roundToInt (options.preRollSeconds * stemSampleRate));
+
+        if (auto writer = createWriter (file, options, stemSampleRate, jmax (1, source.numChannels)))
+            newSession->stems.add (new Stem (source, std::move (writer), file, fifoSize, preRollSize));
+    }
+
+    if (newSession->stems.isEmpty())
+        return false;
+
+    if (! thread.isThreadRunning())
+        thread.startThread (3);
+
+    thread.addTimeSliceClient (newSession.get());
+    session = std::move (newSession);
+    activeSession = session.get();
+    return true;
+}
+
+void CabbageAudioRecorder::startRecording()
+{
+    if (session != nullptr)
+        session->recording = true;
+}
+
+void CabbageAudioRecorder::stop()
+{
+    if (session == nullptr)
+        return;
+
+    //once the audio thread has let go of the session nothing else writes to its FIFOs
+    activeSession = nullptr;
+
+    while (numAudioThreadUsers.load() > 0)
+        Thread::yield();
+
+    thread.removeTimeSliceClient (session.get());
+
+    const bool wasRecording = session->recording.load();
+
+    for (auto* stem : session->stems)
+    {
+        stem->pull (wasRecording);
+        stem->writer.reset();
+
+        //armed but never started, there's nothing worth keeping
+        if (! wasRecording)
+            stem->file.deleteFile();
+    }
+
+    session.reset();
+}
+
+CabbageAudioRecorder::Statistics CabbageAudioRecorder::getStatistics() const
+{
+    Statistics statistics;
+
+    if (session != nullptr)
+    {
+        for (auto* stem : session->stems)
+        {
+            statistics.numSamplesWritten += stem->numSamplesWritten.load();
+            statistics.numSamplesDropped += stem->numSamplesDropped.load();
+            statistics.numOverruns += stem->numOverruns.load();
+        }
+    }
+
+    return statistics;
+}
+
+std::unique_ptr<AudioFormatWriter> CabbageAudioRecorder::createWriter (const File& file, const Options& options, double sampleRate, int numChannels)
+{
+    file.deleteFile();
+    std::unique_ptr<FileOutputStream> fileStream (file.createOutputStream());
+
+    if (fileStream == nullptr)
+        return {};
+
+    std::unique_ptr<AudioFormat> format;
+    int bitDepth = 16;
+
+    if (options.format == Format::flac)
+    {
+        format = std::make_unique<FlacAudioFormat>();
+        bitDepth = options.bitDepth > 16 ? 24 : 16;
+    }
+    else
+    {
+        format = std::make_unique<WavAudioFormat>();
+        bitDepth = options.bitDepth >= 32 ? 32 : (options.bitDepth > 16 ? 24 : 16);
+    }
+
+    if (auto* writer = format->createWriterFor (fileStream.get(), sampleRate, (unsigned int) numChannels, bitDepth, {}, 0))
+    {
+        //the writer owns the stream from here on
+        fileStream.release();
+        return std::unique_ptr<AudioFormatWriter> (writer);
+    }
+
+    return {};
+}
+
+//==============================================================================
+int CabbageAudioRecorder::Session::useTimeSlice()
+{
+    const bool isRecording = recording.load();
+
+    for (auto* stem : stems)
+        stem->pull (isRecording);
+
+    return 10;
+}
+
+//==============================================================================
+CabbageAudioRecorder::Stem::Stem (const StemSource& stemSource, std::unique_ptr<AudioFormatWriter> audioWriter, const File& outputFile,
+                                  int fifoSize, int preRollSize)
+    : source (stemSource),
+      writer (std::move (audioWriter)),
+      file (outputFile),
+      fifoBuffer ((int) writer->getNumChannels(), fifoSize),
+      scratchBuffer ((int) writer->getNumChannels(), 8192),
+      preRollBuffer ((int) writer->getNumChannels(), preRollSize),
+      fifo (fifoSize)
+{
+    fifoBuffer.clear();
+}
+
+void CabbageAudioRecorder::Stem::pull (bool isRecording)
+{
+    if (isRecording)
+        writePreRoll();
+
+    for (int numReady = fifo.getNumReady(); numReady > 0; numReady = fifo.getNumReady())
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (jmin (numReady, scratchBuffer.getNumSamples()), start1, size1, start2, size2);
+
+        for (int channel = 0; channel < scratchBuffer.getNumChannels(); channel++)
+        {
+            scratchBuffer.copyFrom (channel, 0, fifoBuffer, channel, start1, size1);
+            if (size2 > 0)
+                scratchBuffer.copyFrom (channel, size1, fifoBuffer, channel, start2, size2);
+        }
+
+        const int numSamples = size1 + size2;
+        fifo.finishedRead (numSamples);
+
+        if (isRecording)
+        {
+            writer->writeFromAudioSampleBuffer (scratchBuffer, 0, numSamples);
+            numSamplesWritten.store (numSamplesWritten.load() + numSamples);
+        }
+        else if (preRollBuffer.getNumSamples() > 0)
+        {
+            //keep the most recent preRollSize samples in a circular buffer
+            const int preRollSize = preRollBuffer.getNumSamples();
+
+            for (int i = 0; i < numSamples; )
+            {
+                const int numToCopy = jmin (numSamples - i, preRollSize - preRollWritePosition);
+
+                for (int channel = 0; channel < preRollBuffer.getNumChannels(); channel++)
+                    preRollBuffer.copyFrom (channel, preRollWritePosition, scratchBuffer, channel, i, numToCopy);
+
+                preRollWritePosition = (preRollWritePosition + numToCopy) % preRollSize;
+                preRollNumSamples = jmin (preRollSize, preRollNumSamples + numToCopy);
+                i += numToCopy;
+            }
+        }
+    }
+}
+
+void CabbageAudioRecorder::Stem::writePreRoll()
+{
+    if (preRollNumSamples == 0)
+        return;
+
+    const int preRollSize = preRollBuffer.getNumSamples();
+    const int start = (preRollWritePosition - preRollNumSamples + preRollSize) % preRollSize;
+    const int size1 = jmin (preRollNumSamples, preRollSize - start);
+
+    writer->writeFromAudioSampleBuffer (preRollBuffer, start, size1);
+    if (preRollNumSamples > size1)
+        writer->writeFromAudioSampleBuffer (preRollBuffer, 0, preRollNumSamples - size1);
+
+    numSamplesWritten.store (numSamplesWritten.load() + preRollNumSamples);
+    preRollNumSamples = 0;
+}
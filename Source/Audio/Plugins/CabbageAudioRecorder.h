@@ -0,0 +1,216 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEAUDIORECORDER_H_INCLUDED
+#define CABBAGEAUDIORECORDER_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <csound.h>
+
+//==============================================================================
+// Records the processor's outputs to disk as one or more stems: the main
+// outputs, each output bus, and any Csound audio channels. Every stem gets a
+// FIFO that is allocated when recording is armed, so all the audio thread
+// ever does is copy samples into it. Encoding and disk access happen on the
+// recorder's own thread. When nothing is armed the audio thread only checks
+// a pointer.
+//==============================================================================
+class CabbageAudioRecorder
+{
+public:
+    enum class Format
+    {
+        wav,
+        flac
+    };
+
+    struct Options
+    {
+        File file;                          //the main outputs go here, other stems are written alongside it
+        Format format = Format::wav;
+        int bitDepth = 32;                  //32 writes floating point WAV, FLAC is limited to 24
+        bool recordMainOutputs = true;
+        bool recordOutputBuses = false;     //one file per output bus
+        StringArray csoundChannels;         //one mono file per Csound audio channel
+        double preRollSeconds = 0;          //audio kept from before startRecording() while armed
+    };
+
+    struct StemSource
+    {
+        String name;                        //appended to the file name, the main outputs don't have one
+        int firstChannel = 0;               //channel range in the process block buffer
+        int numChannels = 0;
+        const MYFLT* csoundChannel = nullptr;   //set for Csound audio channel stems, which are always mono
+        float gain = 1.f;
+        double sampleRate = 0;              //Csound's rate for Csound channel stems, which differs from the host's when oversampling, 0 uses the rate passed to arm()
+    };
+
+    struct Statistics
+    {
+        int64 numSamplesWritten = 0;
+        int64 numSamplesDropped = 0;
+        int numOverruns = 0;
+    };
+
+    CabbageAudioRecorder() = default;
+    ~CabbageAudioRecorder();
+
+    //message thread
+    bool arm (const Options& options, const Array<StemSource>& sources, double sampleRate);
+    void startRecording();
+    void stop();
+    bool isArmed() const        {   return session != nullptr;  }
+    bool isRecording() const    {   return session != nullptr && session->recording.load();  }
+    Statistics getStatistics() const;
+
+    //audio thread
+    template <typename Type>
+    void processBlock (const AudioBuffer<Type>& buffer)
+    {
+        if (activeSession.load() == nullptr)
+            return;
+
+        const ScopedAudioThreadAccess access (numAudioThreadUsers);
+
+        if (auto* s = activeSession.load())
+        {
+            for (auto* stem : s->stems)
+            {
+                if (stem->source.csoundChannel != nullptr)
+                    continue;
+
+                const int firstChannel = jmin (stem->source.firstChannel, buffer.getNumChannels());
+                const int numChannels = jmin (stem->source.numChannels, buffer.getNumChannels() - firstChannel);
+                stem->push (buffer.getArrayOfReadPointers() + firstChannel, numChannels, buffer.getNumSamples());
+            }
+        }
+    }
+
+    //audio thread, once per k-cycle
+    void processCsoundChannels (int ksmps)
+    {
+        if (activeSession.load() == nullptr)
+            return;
+
+        const ScopedAudioThreadAccess access (numAudioThreadUsers);
+
+        if (auto* s = activeSession.load())
+        {
+            for (auto* stem : s->stems)
+                if (stem->source.csoundChannel != nullptr)
+                    stem->push (&stem->source.csoundChannel, 1, ksmps);
+        }
+    }
+
+private:
+    struct ScopedAudioThreadAccess
+    {
+        explicit ScopedAudioThreadAccess (std::atomic<int>& c) : count (c)  {   ++count;    }
+        ~ScopedAudioThreadAccess()                                          {   --count;    }
+        std::atomic<int>& count;
+    };
+
+    //==============================================================================
+    class Stem
+    {
+    public:
+        Stem (const StemSource& stemSource, std::unique_ptr<AudioFormatWriter> audioWriter, const File& outputFile,
+              int fifoSize, int preRollSize);
+
+        template <typename Type>
+        void push (const Type* const* channels, int numChannels, int numSamples)
+        {
+            if (fifo.getFreeSpace() < numSamples)
+            {
+                numSamplesDropped.store (numSamplesDropped.load() + numSamples);
+                numOverruns.store (numOverruns.load() + 1);
+                return;
+            }
+
+            int start1, size1, start2, size2;
+            fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+            for (int channel = 0; channel < fifoBuffer.getNumChannels(); channel++)
+            {
+                float* dest = fifoBuffer.getWritePointer (channel);
+
+                if (channel < numChannels)
+                {
+                    copySamples (dest + start1, channels[channel], size1, source.gain);
+                    copySamples (dest + start2, channels[channel] + size1, size2, source.gain);
+                }
+                else
+                {
+                    FloatVectorOperations::clear (dest + start1, size1);
+                    FloatVectorOperations::clear (dest + start2, size2);
+                }
+            }
+
+            fifo.finishedWrite (size1 + size2);
+        }
+
+        //recorder thread
+        void pull (bool isRecording);
+
+        const StemSource source;
+        std::unique_ptr<AudioFormatWriter> writer;
+        const File file;
+        std::atomic<int64> numSamplesWritten { 0 }, numSamplesDropped { 0 };
+        std::atomic<int> numOverruns { 0 };
+
+    private:
+        static void copySamples (float* dest, const float* src, int numSamples, float gain)
+        {
+            FloatVectorOperations::copyWithMultiply (dest, src, gain, numSamples);
+        }
+
+        static void copySamples (float* dest, const double* src, int numSamples, float gain)
+        {
+            for (int i = 0; i < numSamples; i++)
+                dest[i] = float (src[i]) * gain;
+        }
+
+        void writePreRoll();
+
+        AudioBuffer<float> fifoBuffer, scratchBuffer, preRollBuffer;
+        AbstractFifo fifo;
+        int preRollWritePosition = 0, preRollNumSamples = 0;
+    };
+
+    //==============================================================================
+    class Session : public TimeSliceClient
+    {
+    public:
+        int useTimeSlice() override;
+
+        OwnedArray<Stem> stems;
+        std::atomic<bool> recording { false };
+    };
+
+    static std::unique_ptr<AudioFormatWriter> createWriter (const File& file, const Options& options, double sampleRate, int numChannels);
+
+    TimeSliceThread thread { "Audio Recorder Thread" };
+    std::unique_ptr<Session> session;
+    std::atomic<Session*> activeSession { nullptr };
+    std::atomic<int> numAudioThreadUsers { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageAudioRecorder)
+};
+
+#endif  // CABBAGEAUDIORECORDER_H_INCLUDED
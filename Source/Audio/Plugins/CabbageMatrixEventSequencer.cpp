@@ -0,0 +1,280 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CabbageMatrixEventSequencer.h"
+
+//==============================================================================
+CabbageMatrixEventSequencer::CabbageMatrixEventSequencer (const String& csoundChannel, int columns, int rows, bool rowsAreSteps)
+    : channel (csoundChannel),
+      numColumns (jmax (1, columns)),
+      numRows (jmax (1, rows)),
+      stepsAreRows (rowsAreSteps),
+      numSteps (rowsAreSteps ? numRows : numColumns),
+      numTracks (rowsAreSteps ? numColumns : numRows),
+      cells ((size_t) (numSteps * numTracks)),
+      stepEvents ((size_t) numTracks),
+      edits ((size_t) jmax (64, numSteps * numTracks * 2)),
+      editFifo ((int) edits.size()),
+      trackLengths (new std::atomic<int>[(size_t) numTracks]),
+      currentSteps (new std::atomic<int>[(size_t) numTracks])
+{
+    for (int track = 0; track < numTracks; track++)
+    {
+        trackLengths[track] = numSteps;
+        currentSteps[track] = -1;
+    }
+
+    cellText.insertMultiple (0, String(), numSteps * numTracks);
+}
+
+//==============================================================================
+void CabbageMatrixEventSequencer::setCell (int column, int row, const String& eventText, const String& displayText)
+{
+    int step, track;
+    toStepAndTrack (column, row, step, track);
+
+    if (! isPositiveAndBelow (step, numSteps) || ! isPositiveAndBelow (track, numTracks))
+        return;
+
+    cellText.set (step * numTracks + track, displayText);
+
+    CellEdit edit;
+    edit.step = step;
+    edit.track = track;
+
+    if (! parseCell (eventText, edit.cell))
+        DBG ("CabbageMatrixEventSequencer: can't play \"" + eventText + "\", only numeric p-fields are supported");
+
+    pendingEdits.add (edit);
+    pushPendingEdits();
+}
+
+String CabbageMatrixEventSequencer::getCellText (int column, int row) const
+{
+    int step, track;
+    toStepAndTrack (column, row, step, track);
+    return cellText[step * numTracks + track];
+}
+
+void CabbageMatrixEventSequencer::setTiming (double stepSizeInBeats, double swingAmount, double bpm)
+{
+    stepSize = jmax (0.0, stepSizeInBeats);
+    swing = jlimit (0.0, 0.75, swingAmount);
+
+    if (bpm > 0)
+        freeRunningBpm = bpm;
+}
+
+void CabbageMatrixEventSequencer::setTrackLengths (const var& lengths)
+{
+    for (int track = 0; track < numTracks; track++)
+    {
+        const int length = lengths.isArray() ? (track < lengths.size() ? int (lengths[track]) : numSteps) : int (lengths);
+        trackLengths[track] = length > 0 ? jmin (length, numSteps) : numSteps;
+    }
+}
+
+int CabbageMatrixEventSequencer::getCurrentStep (int track)
+{
+    //the widget polls this, so it's a good place to retry edits that didn't fit last time
+    pushPendingEdits();
+    return isPositiveAndBelow (track, numTracks) ? currentSteps[track].load() : -1;
+}
+
+//==============================================================================
+void CabbageMatrixEventSequencer::process (const AudioPlayHead::CurrentPositionInfo* position, int numSamples, double sampleRate,
+                                           int firstKCycle, CsoundScoreEventQueue& queue)
+{
+    applyEdits();
+
+    const double step = stepSize.load();
+
+    if (step <= 0 || sampleRate <= 0 || numSamples <= 0)
+        return;
+
+    double ppqStart, bpm;
+
+    if (position != nullptr)
+    {
+        if (! position->isPlaying)
+        {
+            lastPpqEnd = -1;
+            return;
+        }
+
+        ppqStart = position->ppqPosition;
+        bpm = position->bpm;
+    }
+    else
+    {
+        ppqStart = freeRunningPpq;
+        bpm = freeRunningBpm.load();
+    }
+
+    if (bpm <= 0)
+        return;
+
+    const double samplesPerBeat = sampleRate * 60.0 / bpm;
+    const double ppqEnd = ppqStart + numSamples / samplesPerBeat;
+    const double swingOffset = swing.load() * step;
+
+    if (position == nullptr)
+        freeRunningPpq = ppqEnd;
+
+    //anything other than carrying on from the last block, a loop or a relocate, starts counting again
+    const bool continuous = lastPpqEnd >= 0 && std::abs (ppqStart - lastPpqEnd) < step * 0.01;
+
+    if (! continuous)
+        lastTriggeredStep = (int64) std::floor (ppqStart / step) - 1;
+
+    for (int64 k = lastTriggeredStep + 1;; k++)
+    {
+        const double stepStart = k * step + ((k & 1) != 0 ? swingOffset : 0.0);
+
+        if (stepStart >= ppqEnd)
+            break;
+
+        lastTriggeredStep = k;
+
+        if (k < 0 || (! continuous && stepStart < ppqStart))
+            continue;
+
+        //steps that rounding pushed just before the block are played straight away
+        const int sampleInBlock = roundToInt ((stepStart - ppqStart) * samplesPerBeat);
+        triggerStep (k, jmax (0, sampleInBlock - firstKCycle), queue);
+    }
+
+    lastPpqEnd = ppqEnd;
+}
+
+void CabbageMatrixEventSequencer::triggerStep (int64 stepIndex, int sampleOffset, CsoundScoreEventQueue& queue)
+{
+    int numEvents = 0;
+
+    for (int track = 0; track < numTracks; track++)
+    {
+        const int step = (int) (stepIndex % trackLengths[track].load());
+        currentSteps[track].store (step);
+
+        const Cell& cell = cells[(size_t) (step * numTracks + track)];
+
+        if (cell.type == 0)
+            continue;
+
+        auto& event = stepEvents[(size_t) numEvents++];
+        event.type = cell.type;
+        event.pFields = cell.pFields;
+        event.numPFields = cell.numPFields;
+        event.sampleOffset = sampleOffset;
+    }
+
+    if (numEvents > 0)
+        queue.add (stepEvents.data(), numEvents);
+}
+
+//==============================================================================
+bool CabbageMatrixEventSequencer::parseCell (const String& text, Cell& cell)
+{
+    cell = Cell();
+
+    StringArray tokens;
+    tokens.addTokens (text.trim(), " \t", "\"");
+    tokens.removeEmptyStrings();
+
+    if (tokens.isEmpty())
+        return true;
+
+    //"i1 0 1" and "i 1 0 1" are both fine
+    const juce_wchar type = tokens[0][0];
+
+    if (! String ("ifaeq").containsChar (type))
+        return false;
+
+    if (tokens[0].length() > 1)
+        tokens.set (0, tokens[0].substring (1));
+    else
+        tokens.remove (0);
+
+    if (tokens.size() > maxPFields)
+        return false;
+
+    //named instruments and string p-fields would need Csound to parse them
+    for (int i = 0; i < tokens.size(); i++)
+    {
+        if (! tokens[i].containsOnly ("0123456789.-+eE"))
+            return false;
+
+        cell.pFields[i] = tokens[i].getDoubleValue();
+    }
+
+    cell.type = (char) type;
+    cell.numPFields = tokens.size();
+    return true;
+}
+
+void CabbageMatrixEventSequencer::toStepAndTrack (int column, int row, int& step, int& track) const
+{
+    step = stepsAreRows ? row : column;
+    track = stepsAreRows ? column : row;
+}
+
+void CabbageMatrixEventSequencer::pushPendingEdits()
+{
+    const int numToWrite = jmin (pendingEdits.size(), editFifo.getFreeSpace());
+
+    if (numToWrite == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    editFifo.prepareToWrite (numToWrite, start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; i++)
+        edits[(size_t) (start1 + i)] = pendingEdits.getReference (i);
+
+    for (int i = 0; i < size2; i++)
+        edits[(size_t) (start2 + i)] = pendingEdits.getReference (size1 + i);
+
+    editFifo.finishedWrite (size1 + size2);
+    pendingEdits.removeRange (0, size1 + size2);
+}
+
+void CabbageMatrixEventSequencer::applyEdits()
+{
+    const int numReady = editFifo.getNumReady();
+
+    if (numReady == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    editFifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; i++)
+    {
+        const auto& edit = edits[(size_t) (start1 + i)];
+        cells[(size_t) (edit.step * numTracks + edit.track)] = edit.cell;
+    }
+
+    for (int i = 0; i < size2; i++)
+    {
+        const auto& edit = edits[(size_t) (start2 + i)];
+        cells[(size_t) (edit.step * numTracks + edit.track)] = edit.cell;
+    }
+
+    editFifo.finishedRead (size1 + size2);
+}
@@ -0,0 +1,104 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEMATRIXEVENTSEQUENCER_H_INCLUDED
+#define CABBAGEMATRIXEVENTSEQUENCER_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "CsoundScoreEventQueue.h"
+
+//==============================================================================
+// Step sequencer behind an eventsequencer widget. Cells are parsed into
+// p-fields when they're edited. The edits reach the audio thread through a
+// FIFO, so playback never reads a half-written cell. On the audio thread,
+// steps are timed against the host's playhead, or against the widget's bpm
+// when there is no playhead. Each step is queued as score events with the
+// sample offset it falls on. Tracks can have their own length and odd steps
+// can be swung. The widget only displays the steps the engine reports.
+// Nothing plays until stepSize() is set, so eventsequencers that are
+// stepped from Csound behave as before.
+//==============================================================================
+class CabbageMatrixEventSequencer
+{
+public:
+    static constexpr int maxPFields = 32;
+
+    //with stepsAreRows each column is a track, otherwise each row is
+    CabbageMatrixEventSequencer (const String& csoundChannel, int columns, int rows, bool rowsAreSteps);
+
+    const String channel;
+    const int numColumns, numRows;
+    const bool stepsAreRows;
+
+    //message thread
+    void setCell (int column, int row, const String& eventText, const String& displayText);
+    String getCellText (int column, int row) const;
+    void setTiming (double stepSizeInBeats, double swingAmount, double bpm);
+    void setTrackLengths (const var& lengths);
+    int getNumTracks() const    {   return numTracks;   }
+    int getCurrentStep (int track);
+    bool isRunning() const      {   return stepSize.load() > 0;    }
+
+    //audio thread, once per block, before Csound performs any of it. firstKCycle is the
+    //sample in the block where the next k-cycle starts, sample offsets are relative to it
+    void process (const AudioPlayHead::CurrentPositionInfo* position, int numSamples, double sampleRate,
+                  int firstKCycle, CsoundScoreEventQueue& queue);
+
+private:
+    struct Cell
+    {
+        char type = 0;                      //0 for an empty cell or one that couldn't be parsed
+        int numPFields = 0;
+        MYFLT pFields[maxPFields] = {};
+    };
+
+    struct CellEdit
+    {
+        int step = 0, track = 0;
+        Cell cell;
+    };
+
+    static bool parseCell (const String& text, Cell& cell);
+    void toStepAndTrack (int column, int row, int& step, int& track) const;
+    void pushPendingEdits();
+    void applyEdits();
+    void triggerStep (int64 stepIndex, int sampleOffset, CsoundScoreEventQueue& queue);
+
+    const int numSteps, numTracks;
+
+    //audio thread only
+    std::vector<Cell> cells;
+    std::vector<CsoundScoreEventQueue::Event> stepEvents;
+    int64 lastTriggeredStep = -1;
+    double lastPpqEnd = -1, freeRunningPpq = 0;
+
+    //message thread to audio thread
+    std::vector<CellEdit> edits;
+    AbstractFifo editFifo;
+    std::unique_ptr<std::atomic<int>[]> trackLengths, currentSteps;
+    std::atomic<double> stepSize { 0 }, swing { 0 }, freeRunningBpm { 60 };
+
+    //message thread only
+    StringArray cellText;
+    Array<CellEdit> pendingEdits;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageMatrixEventSequencer)
+};
+
+#endif  // CABBAGEMATRIXEVENTSEQUENCER_H_INCLUDED
@@ -67,6 +67,7 @@ CabbagePluginEditor::CabbagePluginEditor (CabbagePluginProcessor& p)
     layoutEditor.setEnabled (false);
     layoutEditor.toFront (false);
     layoutEditor.setInterceptsMouseClicks (true, true);
+    showRepaintCostOverlay (repaintCostOverlayIsEnabled);
 #endif
     resized();
 
@@ -81,6 +82,7 @@ CabbagePluginEditor::CabbagePluginEditor (CabbagePluginProcessor& p)
     isBypassedValue.addListener(this);
     //start thread to check bypass
     startTimer(100);
+    cabbageProcessor.setEditorShowing (true);
 
 }
 
@@ -88,10 +90,13 @@ CabbagePluginEditor::~CabbagePluginEditor()
 {
     setLookAndFeel (nullptr);
     popupPlants.clear();
+    componentsByName.clear();
+    numNamedComponents = 0;
     components.clear();
     radioGroups.clear();
     radioComponents.clear();
     cabbageProcessor.editorIsOpen = false;
+    cabbageProcessor.setEditorShowing (false);
 
     detachOpenGL();
 
@@ -148,7 +153,9 @@ void CabbagePluginEditor::resized()
     sendChannelDataToCsound("SCREEN_HEIGHT", getHeight());
 #if Cabbage_IDE_Build
     layoutEditor.setBounds (getLocalBounds());
-    
+
+    if (repaintCostOverlay != nullptr)
+        repaintCostOverlay->setBounds (getWidth() - 250, 0, 250, 72);
 #endif
     if(viewportContainer)
         viewportContainer->setBounds ( 0, 0, instrumentBounds.getX(), instrumentBounds.getY() );
@@ -172,6 +179,24 @@ void CabbagePluginEditor::resized()
     }
 }
 
+#if Cabbage_IDE_Build
+void CabbagePluginEditor::showRepaintCostOverlay (bool shouldShow)
+{
+    if (! shouldShow)
+    {
+        repaintCostOverlay.reset();
+        return;
+    }
+
+    if (repaintCostOverlay == nullptr)
+    {
+        repaintCostOverlay = std::make_unique<RepaintCostOverlay> (cabbageForm);
+        addAndMakeVisible (repaintCostOverlay.get());
+        resized();
+    }
+}
+#endif
+
 void CabbagePluginEditor::moveBehind(String thisComp, String otherComp)
 {
     auto thisWidget = getComponentFromName(thisComp);
@@ -247,6 +272,8 @@ void CabbagePluginEditor::handleMouseClicks (const MouseEvent& e, bool isMousePr
 //==============================================================================
 void CabbagePluginEditor::createEditorInterface (ValueTree widgets)
 {
+    componentsByName.clear();
+    numNamedComponents = 0;
     components.clear();
 	keyboardCount = 0;
 
@@ -1006,10 +1033,27 @@ void CabbagePluginEditor::resetCurrentlySelectedComponents()
 
 Component* CabbagePluginEditor::getComponentFromName (String& name)
 {
-    for (auto comp : components)
+    for (; numNamedComponents < components.size(); numNamedComponents++)
     {
-        if (name == comp->getName())
-            return comp;
+        //the first component with a name wins, as it always has
+        auto* comp = components[numNamedComponents];
+        if (! componentsByName.contains (comp->getName()))
+            componentsByName.set (comp->getName(), comp);
+    }
+
+    auto* comp = componentsByName[name];
+
+    if (comp != nullptr && comp->getName() == name)
+        return comp;
+
+    //widgets can be renamed after they're indexed, so a miss falls back to a scan and the result is indexed again
+    for (auto c : components)
+    {
+        if (name == c->getName())
+        {
+            componentsByName.set (name, c);
+            return c;
+        }
     }
 
     return nullptr;
@@ -1137,25 +1181,19 @@ void CabbagePluginEditor::updatefTableData (GenTable* table)
                 evt.p[5 + i] = pFields[i];
         }
 
-        StringArray fStatement;
-        int pCnt = 0;
+        //same p-fields as the table we just generated, but for the real table number
+        Array<MYFLT> fStatement;
+        fStatement.add (table->tableNumber);
 
-        for (int i = 0; i < evt.pcnt - 1; i++)
-        {
-            fStatement.add (String (evt.p[i]));
-            pCnt = i;
-        }
+        for (int i = 2; i < evt.pcnt - 1; i++)
+            fStatement.add (evt.p[i]);
 
         if (table->genRoutine != 2)
         {
-            fStatement.add (String (1));
-            fStatement.add (String (evt.p[pCnt]));
+            fStatement.add (1);
+            fStatement.add (evt.p[evt.pcnt - 2]);
         }
 
-        //now set table number and set score char to f
-        fStatement.set (1, String (table->tableNumber));
-        fStatement.set (0, "f");
-
         cabbageProcessor.getCsound()->GetCsound()->hfgens (cabbageProcessor.getCsound()->GetCsound(), &ftpp, &evt, 1);
         Array<float, CriticalSection> points;
 
@@ -1163,7 +1201,7 @@ void CabbagePluginEditor::updatefTableData (GenTable* table)
         table->setWaveform (points, false);
         //table->enableEditMode(fStatement);
 
-        cabbageProcessor.getCsound()->InputMessage (fStatement.joinIntoString (" ").toUTF8());
+        sendScoreEventToCsound ('f', fStatement);
     }
 
 }
@@ -1195,30 +1233,59 @@ void CabbagePluginEditor::sendScoreEventToCsound (const String& scoreEvent)
         cabbageProcessor.getCsound()->InputMessage(scoreEvent.toUTF8());
 }
 
-void CabbagePluginEditor::createEventMatrix(int cols, int rows, String channel)
+void CabbagePluginEditor::sendScoreEventToCsound (char type, const Array<MYFLT>& pFields, int sampleOffset)
 {
     if (cabbageProcessor.csdCompiledWithoutError())
-        cabbageProcessor.createMatrixEventSequencer(rows, cols, std::move(channel));
+        cabbageProcessor.sendScoreEvent (type, pFields.begin(), pFields.size(), sampleOffset);
 }
 
-void CabbagePluginEditor::setEventMatrixData(int cols, int rows, const String& channel, String data)
+bool CabbagePluginEditor::createEventMatrix(int cols, int rows, String channel, bool stepsAreRows)
 {
     if (cabbageProcessor.csdCompiledWithoutError())
-        cabbageProcessor.setMatrixEventSequencerCellData(cols, rows, channel, data);
+        return cabbageProcessor.createMatrixEventSequencer(rows, cols, std::move(channel), stepsAreRows);
+
+    return false;
 }
 
+void CabbagePluginEditor::setEventMatrixData(int cols, int rows, const String& channel, String data, const String& displayText)
+{
+    if (cabbageProcessor.csdCompiledWithoutError())
+        cabbageProcessor.setMatrixEventSequencerCellData(cols, rows, channel, data, displayText);
+}
 
-Array<float, CriticalSection> CabbagePluginEditor::getArrayForSignalDisplay (const String signalVariable, const String displayType)
+String CabbagePluginEditor::getEventMatrixData(int col, int row, const String& channel)
 {
-    if (csdCompiledWithoutError())
-        return cabbageProcessor.getSignalArray (signalVariable, displayType)->getPoints();
+    if (auto* matrix = cabbageProcessor.getMatrixEventSequencer(channel))
+        return matrix->getCellText(col, row);
 
-    return Array<float, CriticalSection>();
+    return {};
+}
+
+void CabbagePluginEditor::setEventMatrixTiming(const String& channel, double stepSize, double swing, double bpm, const var& trackLengths)
+{
+    if (auto* matrix = cabbageProcessor.getMatrixEventSequencer(channel))
+    {
+        matrix->setTiming(stepSize, swing, bpm);
+        matrix->setTrackLengths(trackLengths);
+    }
 }
 
-bool CabbagePluginEditor::shouldUpdateSignalDisplay(String signalVariableName)
+int CabbagePluginEditor::getEventMatrixCurrentStep(const String& channel, int track)
 {
-    return cabbageProcessor.shouldUpdateSignalDisplay(signalVariableName);
+    if (auto* matrix = cabbageProcessor.getMatrixEventSequencer(channel))
+        return matrix->getCurrentStep(track);
+
+    return -1;
+}
+
+
+bool CabbagePluginEditor::getSignalDisplayPoints (const String& signalVariable, const String& displayType, Array<float, CriticalSection>& points, int& lastFrameSeen)
+{
+    if (csdCompiledWithoutError())
+        if (auto* signalDisplay = cabbageProcessor.getSignalArray (signalVariable, displayType))
+            return signalDisplay->getPoints (points, lastFrameSeen);
+
+    return false;
 }
 
 void CabbagePluginEditor::enableXYAutomator (String name, bool enable, Line<float> dragLine)
@@ -1313,3 +1380,8 @@ String CabbagePluginEditor::getCsoundOutputFromProcessor()
 {
     return cabbageProcessor.getCsoundOutput();
 }
+
+bool CabbagePluginEditor::getCsoundOutputSnapshotFromProcessor (String& text, int& lastVersionSeen)
+{
+    return cabbageProcessor.getCsoundOutputSnapshot (text, lastVersionSeen);
+}
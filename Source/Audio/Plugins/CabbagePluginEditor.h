@@ -151,19 +151,23 @@ public:
     void sendChannelStringDataToCsound (const String& channel, String value);
     float getChannelDataFromCsound (const String& channel);
     void sendScoreEventToCsound (const String& scoreEvent);
-    void createEventMatrix(int cols, int rows, String channel);
-    void setEventMatrixData(int cols, int rows, const String& channel, String data);
+    //typed version, queued for the next k-cycle rather than parsed as score text
+    void sendScoreEventToCsound (char type, const Array<MYFLT>& pFields, int sampleOffset = 0);
+    bool createEventMatrix(int cols, int rows, String channel, bool stepsAreRows);
+    void setEventMatrixData(int cols, int rows, const String& channel, String data, const String& displayText);
+    String getEventMatrixData(int col, int row, const String& channel);
+    void setEventMatrixTiming(const String& channel, double stepSize, double swing, double bpm, const var& trackLengths);
+    int getEventMatrixCurrentStep(const String& channel, int track);
     void setEventMatrixCurrentPosition(int cols, int rows, String channel, int position);
 
-    bool shouldUpdateSignalDisplay(String variableName);
-    
     void setCurrentPreset(String preset);
     String getCurrentPreset() const;
     
     void savePluginStateToFile (String presetName, const String& filename, bool remove = false);
     void restorePluginStateFrom (String childPreset, String filename);
-    Array<float, CriticalSection> getArrayForSignalDisplay (const String signalVariable, const String displayType);
+    bool getSignalDisplayPoints (const String& signalVariable, const String& displayType, Array<float, CriticalSection>& points, int& lastFrameSeen);
     String getCsoundOutputFromProcessor();
+    bool getCsoundOutputSnapshotFromProcessor (String& text, int& lastVersionSeen);
     StringArray getTableStatement (int tableNumber);
     bool csdCompiledWithoutError();
     const Array<float, CriticalSection> getTableFloats (int tableNum);
@@ -214,6 +218,16 @@ public:
     {
         cabbageProcessor.setPreferredLatency(latency);
     }
+
+    void setOversampling(int factor)
+    {
+        //this recompiles Csound, so it can't happen while an identifier update from Csound is still being handled
+        MessageManager::callAsync([safeThis = Component::SafePointer<CabbagePluginEditor>(this), factor]
+        {
+            if (safeThis != nullptr)
+                safeThis->cabbageProcessor.setOversamplingFactor(factor);
+        });
+    }
     
    /* void filesDropped(const StringArray &files, int x, int y) override;
     bool isInterestedInFileDrag(const StringArray &files) override;*/
@@ -299,6 +313,10 @@ public:
     {
         return layoutEditor;
     }
+
+    void showRepaintCostOverlay (bool shouldShow);
+    //editors opened from now on show the overlay, or not
+    static inline bool repaintCostOverlayIsEnabled = false;
 #endif
 
     bool isEditModeEnabled()
@@ -379,9 +397,58 @@ private:
         }
     };
 
+#if Cabbage_IDE_Build
+    //paint time, frame rate and layer renders for the form, updated twice a second
+    class RepaintCostOverlay : public Component, private Timer
+    {
+    public:
+        explicit RepaintCostOverlay (CabbageForm& formToMeasure) : form (formToMeasure)
+        {
+            setInterceptsMouseClicks (false, false);
+            lastNumLayersRendered = CabbageLayerCache::getNumLayersRendered();
+            startTimer (updateIntervalMs);
+        }
+
+        void paint (Graphics& g) override
+        {
+            g.fillAll (Colours::black.withAlpha (0.75f));
+            g.setColour (Colours::white);
+            g.setFont (Font (Font::getDefaultMonospacedFontName(), 12.f, Font::plain));
+            g.drawFittedText (text, getLocalBounds().reduced (6, 4), Justification::topLeft, 4);
+        }
+
+    private:
+        void timerCallback() override
+        {
+            const auto statistics = form.getAndResetPaintStatistics();
+            const int numLayersRendered = CabbageLayerCache::getNumLayersRendered();
+            const double seconds = updateIntervalMs / 1000.0;
+
+            text = String (statistics.numFrames / seconds, 1) + " frames/s\n"
+                 + String (statistics.numFrames > 0 ? statistics.totalPaintMs / statistics.numFrames : 0.0, 2) + " ms/frame, "
+                 + String (statistics.maxPaintMs, 2) + " ms max\n"
+                 + String (statistics.totalPaintMs / (seconds * 10.0), 1) + "% of the message thread\n"
+                 + String ((numLayersRendered - lastNumLayersRendered) / seconds, 1) + " layers rendered/s";
+
+            lastNumLayersRendered = numLayersRendered;
+            repaint();
+        }
+
+        static constexpr int updateIntervalMs = 500;
+        CabbageForm& form;
+        String text;
+        int lastNumLayersRendered = 0;
+    };
+
+    std::unique_ptr<RepaintCostOverlay> repaintCostOverlay;
+#endif
+
     std::unique_ptr<Viewport> viewport;
     std::unique_ptr<ViewportContainer> viewportContainer;
     OwnedArray<Component> components = {};
+    //components are only ever appended or cleared, so the map catches up with any added since the last lookup
+    HashMap<String, Component*> componentsByName;
+    int numNamedComponents = 0;
     Array<Component*> radioComponents;
     OwnedArray<PopupDocumentWindow> popupPlants;
     String lastOpenedDirectory;
@@ -28,8 +28,6 @@
 
 //==============================================================================
 
-char tmp_string[4096] = { 0 };
-
 AudioProcessor* JUCE_CALLTYPE
 
 createPluginFilter() {
@@ -106,39 +104,63 @@ void CabbagePluginProcessor::createCsound(const File& inputFile, bool shouldCrea
 {
 	if (inputFile.existsAsFile()) {
 		Logger::writeToLog("CabbagePluginProcessor::createCsound");
-		setWidthHeight();
-		StringArray linesFromCsd;
-		linesFromCsd.addLines(inputFile.loadFileAsString());
+        sourceCsdFile = inputFile;
+		const String csdText = inputFile.loadFileAsString();
+
+        //instances of the same plugin share everything worked out from the csd. The IDE and
+        //autoUpdate() reloads always parse from scratch, as the file is being edited under them
+        const bool usePreparseCache = shouldCreateParameters && CabbageUtilities::getTarget() != CabbageUtilities::TargetTypes::IDE;
+        const String preparseKey = CabbagePreparseCache::createKey(inputFile, csdText);
+        const auto cachedEntry = usePreparseCache ? preparseCache->find(preparseKey) : nullptr;
+
+        if (cachedEntry != nullptr)
+        {
+            preparsedCsd = cachedEntry;
+            applyPreparseCacheEntry(*preparsedCsd);
+            csdFile = preparsedCsd->expandedCsdFile.existsAsFile() ? preparsedCsd->expandedCsdFile : inputFile;
+
+            if (!setupAndCompileCsound(csdFile, inputFile.getParentDirectory(), samplingRate))
+                this->suspendProcessing(true);
+        }
+        else
+        {
+			setWidthHeight();
+			StringArray linesFromCsd;
+			linesFromCsd.addLines(csdText);
         
-		//only create extended temp file if imported plants are being added...
-		if (addImportFiles(linesFromCsd))
-		{
-			parseCsdFile(linesFromCsd);
+			//only create extended temp file if imported plants are being added...
+			if (addImportFiles(linesFromCsd))
+			{
+				parseCsdFile(linesFromCsd);
 
 
-			File tempFile = File::createTempFile(inputFile.getFileNameWithoutExtension() + "_temp.csd");
-			tempFile.replaceWithText(linesFromCsd.joinIntoString("\n")
-				.replace("$lt;", "<")
-				.replace("&amp;", "&")
-				.replace("$quote;", "\"")
-				.replace("$gt;", ">"));
+				File tempFile = File::createTempFile(inputFile.getFileNameWithoutExtension() + "_temp.csd");
+				tempFile.replaceWithText(linesFromCsd.joinIntoString("\n")
+					.replace("$lt;", "<")
+					.replace("&amp;", "&")
+					.replace("$quote;", "\"")
+					.replace("$gt;", ">"));
 
 
-			//CabbageUtilities::debug(tempFile.loadFileAsString());
+				//CabbageUtilities::debug(tempFile.loadFileAsString());
 
-			if (!setupAndCompileCsound(tempFile, inputFile.getParentDirectory(), samplingRate))
-				this->suspendProcessing(true);
+				if (!setupAndCompileCsound(tempFile, inputFile.getParentDirectory(), samplingRate))
+					this->suspendProcessing(true);
 
-			csdFile = tempFile;
+				csdFile = tempFile;
 
-		}
+			}
 
-		else {
-			parseCsdFile(linesFromCsd);
-			csdFile = inputFile;
-			if (!setupAndCompileCsound(inputFile, inputFile.getParentDirectory(), samplingRate))
-				this->suspendProcessing(true);
-		}
+			else {
+				parseCsdFile(linesFromCsd);
+				csdFile = inputFile;
+				if (!setupAndCompileCsound(inputFile, inputFile.getParentDirectory(), samplingRate))
+					this->suspendProcessing(true);
+			}
+
+            if (usePreparseCache)
+                preparsedCsd = preparseCache->add(createPreparseCacheEntry(preparseKey, inputFile, csdFile != inputFile ? csdFile : File()));
+        }
 
         initAllCsoundChannels(cabbageWidgets);
         
@@ -150,16 +172,18 @@ void CabbagePluginProcessor::createCsound(const File& inputFile, bool shouldCrea
 		
 
 		csdLastModifiedAt = csdFile.getLastModificationTime().toMilliseconds();
+        updateWatchedFiles();
         //getCsound()->SetYieldCallback(CabbagePluginProcessor::csoundYieldCallback);
 	}
 }
 
 CabbagePluginProcessor::~CabbagePluginProcessor()
 {
-	for (auto xyAuto : xyAutomators)
-		xyAuto->removeAllChangeListeners();
-
-	xyAutomators.clear();
+	{
+		const SpinLock::ScopedLockType lock(xyAutomatorLock);
+		xyAutomators.clear();
+	}
+	fileWatcher->removeListener(this);
 	cabbageWidgets.removeAllChildren(nullptr);
 
 	Logger::writeToLog("CabbagePluginProcessor::~CabbagePluginProcessor");
@@ -169,25 +193,65 @@ CabbagePluginProcessor::~CabbagePluginProcessor()
 
 void CabbagePluginProcessor::timerCallback()
 {
-    if(autoUpdateCount == 0 && autoUpdateIsOn)
+    if(pollingChannels() == 0)
     {
-        int64 modTime = csdFile.getLastModificationTime().toMilliseconds();
+        getIdentifierDataFromCsound();
+    }
+    
+    for (auto* xyAuto : xyAutomators)
+        xyAuto->updateHostAndListeners(editorIsOpen);
+}
 
-        if (modTime != csdLastModifiedAt && csdFile.existsAsFile())
+//==============================================================================
+void CabbagePluginProcessor::updateWatchedFiles()
+{
+    if (!autoUpdateIsOn)
+    {
+        fileWatcher->removeListener(this);
+        return;
+    }
+
+    Array<File> files;
+    CabbageFileWatcher::addFileAndIncludes(sourceCsdFile, files);
+    files.addIfNotAlreadyThere(customFontFile);
+
+    //plant imports, and the images and samples widgets load from disk
+    for (const auto& widget : cabbageWidgets)
+    {
+        const String type = CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::type);
+
+        if (type == CabbageWidgetTypes::form)
+        {
+            const var importFiles = CabbageWidgetData::getProperty(widget, CabbageIdentifierIds::importfiles);
+            for (int i = 0; i < importFiles.size(); i++)
+                files.addIfNotAlreadyThere(sourceCsdFile.getParentDirectory().getChildFile(importFiles[i].toString()));
+        }
+
+        //a filebutton's file is picked by the user at runtime, it isn't something the instrument is built from
+        if (type == CabbageWidgetTypes::filebutton)
+            continue;
+
+        for (const auto& identifier : { CabbageIdentifierIds::file, CabbageIdentifierIds::imgfile })
         {
-            csdLastModifiedAt = csdFile.getLastModificationTime().toMilliseconds();
-            CabbageUtilities::debug("resetting file due to update of file on disk");
-            createCsound(csdFile, false);
+            const String file = CabbageWidgetData::getStringProp(widget, identifier);
+            if (file.isNotEmpty())
+                files.addIfNotAlreadyThere(File(CabbageUtilities::getFileAndPath(sourceCsdFile, file)));
         }
     }
-    
-    if(pollingChannels() == 0)
+
+    files.removeFirstMatchingValue(File());
+    fileWatcher->setWatchedFiles(this, files);
+}
+
+void CabbagePluginProcessor::watchedFilesChanged(const Array<File>& changedFiles)
+{
+    ignoreUnused(changedFiles);
+
+    if (autoUpdateIsOn && sourceCsdFile.existsAsFile())
     {
-        getIdentifierDataFromCsound();
+        CabbageUtilities::debug("resetting file due to update of file on disk");
+        createCsound(sourceCsdFile, false);
     }
-    
-    
-    autoUpdateCount = autoUpdateCount < 500 ? autoUpdateCount+1 : 0;
 }
 
 //==============================================================================
@@ -325,25 +389,8 @@ void CabbagePluginProcessor::parseCsdFile(StringArray& linesFromCsd)
 				linesToSkip += plantStruct.cabbageCode.size() + 1;
 		}
 
-		if (typeOfWidget == CabbageWidgetTypes::form) {
-			const String caption = CabbageWidgetData::getStringProp(newWidget, CabbageIdentifierIds::caption);
-			setPluginName(caption.length() > 0 ? caption : "Untitled");
-            
-            const String poll = CabbageWidgetData::getStringProp(newWidget, CabbageIdentifierIds::guimode);
-            if(poll == "polling")
-                pollingChannels(1);
-            else if(poll == "queue")
-                pollingChannels(0);
-            else
-                pollingChannels(2);
-            
-			if (CabbageWidgetData::getNumProp(newWidget, CabbageIdentifierIds::logger) == 1)
-				createFileLogger(this->csdFile);
-
-			setGUIRefreshRate(CabbageWidgetData::getNumProp(newWidget, CabbageIdentifierIds::guirefresh));
-            
-            setNumPreCycles(CabbageWidgetData::getNumProp(newWidget, CabbageIdentifierIds::precycles));
-		}
+		if (typeOfWidget == CabbageWidgetTypes::form)
+			applyFormSettings(newWidget);
         
 		const String precedingCharacters = currentLineOfCabbageCode.substring(0, currentLineOfCabbageCode.indexOf(
 			typeOfWidget));
@@ -401,6 +448,91 @@ void CabbagePluginProcessor::parseCsdFile(StringArray& linesFromCsd)
     
 }
 
+void CabbagePluginProcessor::applyFormSettings(const ValueTree& form)
+{
+    const String caption = CabbageWidgetData::getStringProp(form, CabbageIdentifierIds::caption);
+    setPluginName(caption.length() > 0 ? caption : "Untitled");
+
+    const String poll = CabbageWidgetData::getStringProp(form, CabbageIdentifierIds::guimode);
+    if(poll == "polling")
+        pollingChannels(1);
+    else if(poll == "queue")
+        pollingChannels(0);
+    else
+        pollingChannels(2);
+
+    if (CabbageWidgetData::getNumProp(form, CabbageIdentifierIds::logger) == 1)
+        createFileLogger(this->csdFile);
+
+    const String logLevel = CabbageWidgetData::getStringProp(form, CabbageIdentifierIds::loglevel);
+    if (logLevel.startsWithIgnoreCase("warning"))
+        setCsoundOutputSeverity(CsoundMessageLog::warningSeverity);
+    else if (logLevel.startsWithIgnoreCase("error"))
+        setCsoundOutputSeverity(CsoundMessageLog::errorSeverity);
+    else
+        setCsoundOutputSeverity(CsoundMessageLog::informationSeverity);
+
+    setGUIRefreshRate(CabbageWidgetData::getNumProp(form, CabbageIdentifierIds::guirefresh),
+                      CabbageWidgetData::getStringProp(form, CabbageIdentifierIds::guirefreshunit).equalsIgnoreCase("hz"));
+
+    setNumPreCycles(CabbageWidgetData::getNumProp(form, CabbageIdentifierIds::precycles));
+}
+
+//==============================================================================
+std::shared_ptr<const CabbagePreparseCache::Entry> CabbagePluginProcessor::createPreparseCacheEntry(const String& key, const File& inputFile, const File& expandedCsdFile) const
+{
+    auto entry = std::make_shared<CabbagePreparseCache::Entry>();
+    entry->key = key;
+    entry->widgets = cabbageWidgets.createCopy();
+    entry->expandedCsdFile = expandedCsdFile;
+    entry->macroText = macroText;
+    entry->macroNames = macroNames;
+    entry->macroStrings = macroStrings;
+    entry->screenWidth = screenWidth;
+    entry->screenHeight = screenHeight;
+    entry->autoUpdateIsOn = autoUpdateIsOn;
+    entry->customFont = customFont;
+    entry->customFontFile = customFontFile;
+
+    //the csd itself is covered by the key, but not the files it pulls in
+    entry->addDependency(inputFile);
+    entry->addDependency(customFontFile);
+
+    for (const auto& widget : cabbageWidgets)
+    {
+        if (CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::type) == CabbageWidgetTypes::form)
+        {
+            const var files = CabbageWidgetData::getProperty(widget, CabbageIdentifierIds::importfiles);
+            for (int i = 0; i < files.size(); i++)
+                entry->addDependency(inputFile.getParentDirectory().getChildFile(files[i].toString()));
+        }
+    }
+
+    return entry;
+}
+
+void CabbagePluginProcessor::applyPreparseCacheEntry(const CabbagePreparseCache::Entry& entry)
+{
+    screenWidth = entry.screenWidth;
+    screenHeight = entry.screenHeight;
+    macroText = entry.macroText;
+    macroNames = entry.macroNames;
+    macroStrings = entry.macroStrings;
+    autoUpdateIsOn = entry.autoUpdateIsOn;
+    customFont = entry.customFont;
+    customFontFile = entry.customFontFile;
+
+    cabbageWidgets.removeAllChildren(nullptr);
+
+    for (const auto& widget : entry.widgets)
+    {
+        cabbageWidgets.addChild(widget.createCopy(), -1, nullptr);
+
+        if (CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::type) == CabbageWidgetTypes::form)
+            applyFormSettings(widget);
+    }
+}
+
 bool CabbagePluginProcessor::isWidgetPlantParent(StringArray& linesFromCsd, int lineNumber) {
 	if (linesFromCsd[lineNumber].contains("{"))
 		return true;
@@ -993,15 +1125,20 @@ AudioProcessorEditor* CabbagePluginProcessor::createEditor() {
 void CabbagePluginProcessor::getStateInformation(MemoryBlock& destData) 
 {
     try{
-        auto j = nlohmann::json::parse(addPluginPreset("CABBAGE_PRESETS", "", false).toStdString());
+        //widgets only follow Csound while the editor is open, so catch up before their values are saved
+        if (!editorIsOpen && MessageManager::existsAndIsCurrentThread())
+            updateGuiFromCsound();
+
+        currentPresetName = "CABBAGE_PRESETS";
 
-        nlohmann::json k, l;
+        //hosts can save from any thread, so values set with chnset are read from Csound directly
+        nlohmann::ordered_json k, l;
         l["dummy"] = "dummy";
-        k["daw state"] = j;
+        k["daw state"] = getPluginStateData(currentPresetName, true);
         k["dummy"] = l;
 
-        MemoryOutputStream(destData, true).writeString(k.dump(4));
-        hostStateData = k;
+        //hosts call this on every autosave, so write the compact binary format rather than pretty printed JSON
+        CabbagePluginStateData::write(k, destData);
     }
     catch (nlohmann::json::exception& e) {
         DBG(e.what());
@@ -1015,10 +1152,16 @@ void CabbagePluginProcessor::getStateInformation(MemoryBlock& destData)
 void CabbagePluginProcessor::setStateInformation(const void* data, int sizeInBytes) 
 {
     try{
-	
-		auto jsonData = nlohmann::json::parse(MemoryInputStream(data, static_cast<size_t> (sizeInBytes), false).readString().toStdString());
+        nlohmann::ordered_json jsonData;
+
+        //sessions saved with older versions of Cabbage hold their state as JSON text
+        if (!CabbagePluginStateData::readState(data, sizeInBytes, jsonData))
+        {
+            Logger::writeToLog("CabbagePluginProcessor::setStateInformation - invalid plugin state");
+            return;
+        }
+
         setPluginState(jsonData, "", true);
-        hostStateData = jsonData;
     }
     catch (nlohmann::json::exception& e) {
         DBG(e.what());
@@ -1094,6 +1237,34 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
     
     
     
+    j[currentPresetName.toStdString()] = getPluginStateData(presetName);
+
+	if(fileName.isNotEmpty())
+		presetFile.replaceWithText(String(j.dump(4)));
+
+
+    
+	return  j[currentPresetName.toStdString()].dump();
+
+}
+
+
+//==============================================================================
+nlohmann::ordered_json CabbagePluginProcessor::getPluginStateData(const String& presetName, bool readValuesFromCsound)
+{
+    nlohmann::ordered_json state = nlohmann::ordered_json::object();
+
+    //GetChannel takes the channel's own lock, so this is safe from any thread
+    auto getChannelValue = [this, readValuesFromCsound] (const String& channel, float widgetValue)
+    {
+        if (!readValuesFromCsound || getCsound() == nullptr || channel.isEmpty())
+            return widgetValue;
+
+        int err = 0;
+        const MYFLT value = getCsound()->GetChannel(channel.toUTF8(), &err);
+        return err == CSOUND_SUCCESS ? float(value) : widgetValue;
+    };
+
     for (int i = 0; i < cabbageWidgets.getNumChildren(); i++) {
         const String channelName = CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),
                                                                     CabbageIdentifierIds::channel);
@@ -1104,7 +1275,7 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
         if(channelName == "PluginResizerCombBox" && ignore==0)
         {
             const var value = CabbageWidgetData::getProperty(cabbageWidgets.getChild(i), CabbageIdentifierIds::value);
-            j[currentPresetName.toStdString()][channelName.toStdString()] = float(value);
+            state[channelName.toStdString()] = float(value);
         }
         else if ((type == CabbageWidgetTypes::combobox ||  type == CabbageWidgetTypes::listbox) && CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),                                                                                                CabbageIdentifierIds::filetype).contains("snaps"))
         {
@@ -1112,13 +1283,13 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
             {
                 const String presetN = CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),CabbageIdentifierIds::value);
                 const String presetText = CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),CabbageIdentifierIds::text);
-                j[currentPresetName.toStdString()][channelName.toStdString()] = presetN.toStdString();
+                state[channelName.toStdString()] = presetN.toStdString();
             }
         }
        else if (type == CabbageWidgetTypes::presetbutton)
        {
             const String presetN = CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),CabbageIdentifierIds::value);
-            j[currentPresetName.toStdString()][channelName.toStdString()] = presetN.toStdString();
+            state[channelName.toStdString()] = presetN.toStdString();
        }
        else if(ignore == 0)
         {
@@ -1131,7 +1302,7 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
 				{
                     String text = CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),
                                                                          CabbageIdentifierIds::text);
-                    j[currentPresetName.toStdString()][channelName.toStdString()] = text.toStdString();
+                    state[channelName.toStdString()] = text.toStdString();
                 }
 				if (type == CabbageWidgetTypes::soundfiler) 
 				{
@@ -1150,7 +1321,7 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
 					b[CabbageIdentifierIds::scrubberposition.toString().toStdString()] = scrubberPos;
 					b[CabbageIdentifierIds::regionstart.toString().toStdString()] = regionStart;
 					b[CabbageIdentifierIds::regionlength.toString().toStdString()] = regionLength;
-					j[currentPresetName.toStdString()][String(channelName).toStdString()] = b;
+					state[String(channelName).toStdString()] = b;
 
 				}
                 else if (type == CabbageWidgetTypes::filebutton &&
@@ -1165,7 +1336,7 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
                      {
                          if (file.length() > 2) {
                              const String relativePath = File(csdFile).getParentDirectory().getChildFile(file).getFullPathName();
-                             j[currentPresetName.toStdString()][channelName.toStdString()] = relativePath.replaceCharacters("\\", "/").toStdString();
+                             state[channelName.toStdString()] = relativePath.replaceCharacters("\\", "/").toStdString();
                          }
                      }
                 }
@@ -1181,10 +1352,10 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
 					nlohmann::ordered_json b;
 					b["Range Min"] = minValue;
 					b["Range Max"] = maxValue;
-					j[currentPresetName.toStdString()][channels[0].toString().toStdString()] = b;
+					state[channels[0].toString().toStdString()] = b;
 
-                    //j[currentPresetName.toStdString()][channels[0].toString().toStdString()] = minValue;
-                    //j[currentPresetName.toStdString()][channels[1].toString().toStdString()] = maxValue;
+                    //state[channels[0].toString().toStdString()] = minValue;
+                    //state[channels[1].toString().toStdString()] = maxValue;
                 }
                 else if (type == CabbageWidgetTypes::xypad) //double channel xypad widget
                 {
@@ -1195,12 +1366,12 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
                     const float yValue = CabbageWidgetData::getNumProp(cabbageWidgets.getChild(i),
                                                                        CabbageIdentifierIds::valuey);
                     
-                    //j[currentPresetName.toStdString()][channels[0].toString().toStdString()] = xValue;
-                    //j[currentPresetName.toStdString()][channels[1].toString().toStdString()] = yValue;
+                    //state[channels[0].toString().toStdString()] = xValue;
+                    //state[channels[1].toString().toStdString()] = yValue;
 					nlohmann::ordered_json b;
-					b["X"] = xValue;
-					b["Y"] = yValue;
-					j[currentPresetName.toStdString()][channels[0].toString().toStdString()] = b;
+					b["X"] = getChannelValue(channels[0].toString(), xValue);
+					b["Y"] = getChannelValue(channels[1].toString(), yValue);
+					state[channels[0].toString().toStdString()] = b;
                 }
                 else if (type == CabbageWidgetTypes::combobox && CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),
                                                                                                 CabbageIdentifierIds::filetype).contains("snaps"))
@@ -1214,12 +1385,12 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
                     if(getCsound())
                         getCsound()->GetStringChannel(channelName.getCharPointer(), tmp_str);
                     const String file(tmp_str);
-                    j[currentPresetName.toStdString()][channelName.toStdString()] = file.toStdString();
+                    state[channelName.toStdString()] = file.toStdString();
                     
                 }
                 else
                 {
-                    j[currentPresetName.toStdString()][channelName.toStdString()] = float(value);
+                    state[channelName.toStdString()] = value.isString() ? float(value) : getChannelValue(channelName, float(value));
                 }
             }
         }
@@ -1232,20 +1403,13 @@ String CabbagePluginProcessor::addPluginPreset(String presetName,  const String&
 		if (p != nullptr)
 		{
 			auto pdClass = *p;
-			j[currentPresetName.toStdString()]["cabbageJSONData"] = pdClass->data;
+			state["cabbageJSONData"] = pdClass->data;
 		}
 	}
 
-	if(fileName.isNotEmpty())
-		presetFile.replaceWithText(String(j.dump(4)));
-
-
-    
-	return  j[currentPresetName.toStdString()].dump();
-
+    return state;
 }
 
-
 void CabbagePluginProcessor::setPluginState(nlohmann::ordered_json j, const String presetName, bool hostState)
 {
     try{
@@ -1319,12 +1483,12 @@ void CabbagePluginProcessor::setPluginState(nlohmann::ordered_json j, const Stri
 				}
 				else if (type == CabbageWidgetTypes::soundfiler)
 				{
-					nlohmann::ordered_json b = nlohmann::ordered_json::parse(presetData.value().dump());
+					const nlohmann::ordered_json& b = presetData.value();
 
-					const String absolutePath = String(b[CabbageIdentifierIds::file.toString().toStdString()].dump()).removeCharacters("\"");
-					const int scrubberPos = b[CabbageIdentifierIds::scrubberposition.toString().toStdString()].get<int>();
-					const int regionStart = b[CabbageIdentifierIds::regionstart.toString().toStdString()].get<int>();
-					const int regionLength = b[CabbageIdentifierIds::regionlength.toString().toStdString()].get<int>();
+					const String absolutePath = String(b.at(CabbageIdentifierIds::file.toString().toStdString()).dump()).removeCharacters("\"");
+					const int scrubberPos = b.at(CabbageIdentifierIds::scrubberposition.toString().toStdString()).get<int>();
+					const int regionStart = b.at(CabbageIdentifierIds::regionstart.toString().toStdString()).get<int>();
+					const int regionLength = b.at(CabbageIdentifierIds::regionlength.toString().toStdString()).get<int>();
 
 					/*const String absolutePath =
 					csdFile.getParentDirectory().getChildFile(String(presetData.value().dump()).replaceCharacters("\\", "/")).getFullPathName();*/
@@ -1343,9 +1507,9 @@ void CabbagePluginProcessor::setPluginState(nlohmann::ordered_json j, const Stri
 				else if (type == CabbageWidgetTypes::hrange ||
 					type == CabbageWidgetTypes::vrange) //double channel range widgets
 				{
-					nlohmann::ordered_json b = nlohmann::ordered_json::parse(presetData.value().dump());
-					const float min = b["Range Min"].get<float>();
-					const float max = b["Range Max"].get<float>();
+					const nlohmann::ordered_json& b = presetData.value();
+					const float min = b.at("Range Min").get<float>();
+					const float max = b.at("Range Max").get<float>();
 
 					CabbageWidgetData::setNumProp(valueTree, CabbageIdentifierIds::minvalue, min);
 
@@ -1374,9 +1538,9 @@ void CabbagePluginProcessor::setPluginState(nlohmann::ordered_json j, const Stri
 				else if (type == CabbageWidgetTypes::xypad) //double channel range widgets
 				{
 
-					nlohmann::ordered_json b = nlohmann::ordered_json::parse(presetData.value().dump());
-					const float x = b["X"].get<float>();
-					const float y = b["Y"].get<float>();
+					const nlohmann::ordered_json& b = presetData.value();
+					const float x = b.at("X").get<float>();
+					const float y = b.at("Y").get<float>();
 
 					CabbageWidgetData::setNumProp(valueTree, CabbageIdentifierIds::valuex,x);
 
@@ -1716,15 +1880,12 @@ void CabbagePluginProcessor::getChannelDataFromCsound()
         {
 			const String identChannelMessage = CabbageWidgetData::getStringProp(cabbageWidgets.getChild(i),
 				CabbageIdentifierIds::identchannelmessage);
-			memset(&tmp_string[0], 0, sizeof(tmp_string));
-			getCsound()->GetStringChannel(identChannel.toUTF8(), tmp_string);
-
-			const String identifierText(tmp_string);
+			const String identifierText = readIdentChannel(i, identChannel);
 			//CabbageUtilities::debug(identifierText);
+			//readIdentChannel() has already cleared the channel, repeats of the last message are ignored
 			if (identifierText.isNotEmpty() && identifierText != identChannelMessage)
             {
-                String padded = identifierText.paddedLeft(' ', 1);
-                CabbageWidgetData::setCustomWidgetState(cabbageWidgets.getChild(i), padded);
+                CabbageWidgetData::setCustomWidgetState(cabbageWidgets.getChild(i), identifierText);
 
 				if (identifierText.contains("tableNumber")) //update even if table number has not changed
 					CabbageWidgetData::setProperty(cabbageWidgets.getChild(i), CabbageIdentifierIds::update, 1);
@@ -1733,8 +1894,6 @@ void CabbagePluginProcessor::getChannelDataFromCsound()
 						Random::getSystemRandom().nextInt());
 				}
 
-				getCsound()->SetChannel(identChannel.toUTF8(), (char*) "");
-				
 				CabbageWidgetData::setProperty(cabbageWidgets.getChild(i), CabbageIdentifierIds::update,
 					0); //reset value for further updates
 
@@ -1755,6 +1914,92 @@ void CabbagePluginProcessor::getChannelDataFromCsound()
 	}
 }
 
+//==============================================================================
+// Identifier strings written to an identchannel are cleared as soon as they've
+// been read, so an empty channel means there's nothing new. The channel is
+// checked in place, under its lock, and only copied when a message is
+// waiting. Channels are looked up by name once per Csound instance rather
+// than on every update, and only once Csound has created them, as asking
+// for a pointer would otherwise create the channel.
+//==============================================================================
+bool CabbagePluginProcessor::identStringChannelExists(const String& channelName)
+{
+    //channels only appear when an instrument first writes to them, so the list is refreshed now and again
+    const uint32 now = Time::getMillisecondCounter();
+
+    if (identStringChannelsListTime == 0 || now - identStringChannelsListTime > 250)
+    {
+        identStringChannels.clearQuick();
+        identStringChannelsListTime = jmax((uint32) 1, now);
+
+        controlChannelInfo_t* channelList = nullptr;
+        const int numChannels = getCsound()->ListChannels(channelList);
+
+        for (int i = 0; i < numChannels; i++)
+            if ((channelList[i].type & CSOUND_CHANNEL_TYPE_MASK) == CSOUND_STRING_CHANNEL)
+                identStringChannels.add(channelList[i].name);
+
+        if (channelList != nullptr)
+            getCsound()->DeleteChannelList(channelList);
+    }
+
+    return identStringChannels.contains(channelName);
+}
+
+String CabbagePluginProcessor::readIdentChannel(int widgetIndex, const String& channelName)
+{
+    if (identChannelsCsoundInstance != getCsoundInstanceNumber())
+    {
+        identChannels.clearQuick();
+        identChannelsCsoundInstance = getCsoundInstanceNumber();
+        identStringChannelsListTime = 0;
+    }
+
+    while (identChannels.size() <= widgetIndex)
+        identChannels.add(new IdentChannel());
+
+    auto& channel = *identChannels.getUnchecked(widgetIndex);
+
+    if (channel.name != channelName)
+    {
+        channel.name = channelName;
+        channel.data = nullptr;
+        channel.lock = nullptr;
+    }
+
+    if (channel.data == nullptr && identStringChannelExists(channelName))
+    {
+        MYFLT* data = nullptr;
+
+        if (getCsound()->GetChannelPtr(data, channelName.toUTF8(), CSOUND_STRING_CHANNEL | CSOUND_OUTPUT_CHANNEL) == CSOUND_SUCCESS)
+        {
+            channel.data = reinterpret_cast<STRINGDAT*>(data);
+            channel.lock = getCsound()->GetChannelLock(channelName.toUTF8());
+        }
+    }
+
+    if (channel.data == nullptr || channel.lock == nullptr)
+        return {};
+
+    //Csound's performance thread spins on this lock in chnset, so only a bounded copy happens while it's held
+    csoundSpinLock(channel.lock);
+
+    int length = 0;
+
+    if (channel.data->data != nullptr)
+        for (; length < IdentChannel::maxMessageSize - 1 && channel.data->data[length] != 0; length++)
+            channel.message[length] = channel.data->data[length];
+
+    channel.message[length] = 0;
+
+    //every message is consumed, even one that repeats the last, so it isn't picked up again on the next update
+    if (length > 0)
+        channel.data->data[0] = 0;
+
+    csoundSpinUnLock(channel.lock);
+    return channel.message[0] != 0 ? String::fromUTF8(channel.message) : String();
+}
+
 //================================================================================
 void CabbagePluginProcessor::addXYAutomator(CabbageXYPad* xyPad, const ValueTree& wData) {
 	int indexOfAutomator = -1;
@@ -1765,18 +2010,15 @@ void CabbagePluginProcessor::addXYAutomator(CabbageXYPad* xyPad, const ValueTree
 	}
 
 	if (indexOfAutomator == -1) {
-		XYPadAutomator* xyAuto;
 		CabbagePluginParameter* xParameter = getParameterForXYPad(xyPad->getName() + "_x");
 		CabbagePluginParameter* yParameter = getParameterForXYPad(xyPad->getName() + "_y");
 
 		if (xParameter && yParameter) {
-			xyAutomators.add(xyAuto = new XYPadAutomator(xyPad->getName(), xParameter, yParameter, this));
-			xyAuto->setXMin(CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::minx));
-			xyAuto->setYMin(CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::miny));
-			xyAuto->setXMax(CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::maxx));
-			xyAuto->setYMax(CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::maxy));
-			xyAuto->removeAllChangeListeners();
+			auto xyAuto = std::make_unique<XYPadAutomator>(xyPad->getName(), xParameter, yParameter, wData);
 			xyAuto->addChangeListener(xyPad);
+
+			const SpinLock::ScopedLockType lock(xyAutomatorLock);
+			xyAutomators.add(xyAuto.release());
 		}
 	}
 	else {
@@ -1790,28 +2032,41 @@ void CabbagePluginProcessor::enableXYAutomator(String name, bool enable, Line<fl
 
 	for (XYPadAutomator* xyAuto : xyAutomators) {
 		if (name == xyAuto->getName()) {
-			if (enable == true) {
-				xyAuto->setDragLine(dragLine);
-				xyAuto->setXValue(dragLine.getEndX());
-				xyAuto->setYValue(dragLine.getEndY());
-				xyAuto->setXValueIncrement((dragLine.getEndX() - dragLine.getStartX()) * .05);
-				xyAuto->setYValueIncrement((dragLine.getEndY() - dragLine.getStartY()) * .05);
-				xyAuto->setRepaintBackground(true);
-                if(editorIsOpen)
-                    xyAuto->setIsPluginEditorOpen(true);
-				xyAuto->startTimer(20);
-			}
+			if (enable == true)
+				xyAuto->start(dragLine);
 			else
-				xyAuto->stopTimer();
+				xyAuto->stop();
 		}
 	}
 }
 
 void CabbagePluginProcessor::disableXYAutomators() 
 {
+	//the pads are going away with the editor, the automators keep running without them
 	for (XYPadAutomator* xyAuto : xyAutomators) 
 	{
-		xyAuto->setIsPluginEditorOpen(false);
+		xyAuto->removeAllChangeListeners();
+	}
+}
+
+void CabbagePluginProcessor::processAutomation(int numSamples)
+{
+	//called on the audio thread before each k-cycle, skip it if the message thread is adding an automator
+	const SpinLock::ScopedTryLockType lock(xyAutomatorLock);
+
+	if (!lock.isLocked() || getCsound() == nullptr)
+		return;
+
+	//numSamples are Csound samples, which run faster than the host's when oversampling
+	const double csoundSampleRate = getCsound()->GetSr();
+
+	for (XYPadAutomator* xyAuto : xyAutomators)
+	{
+		if (xyAuto->process(numSamples, csoundSampleRate))
+		{
+			getCsound()->SetChannel(xyAuto->getXChannel(), xyAuto->getXChannelValue());
+			getCsound()->SetChannel(xyAuto->getYChannel(), xyAuto->getYChannelValue());
+		}
 	}
 }
 
@@ -1865,56 +2120,70 @@ void CabbagePluginProcessor::setCabbageParameter(String& channel, float value, V
 
 void CabbagePluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-	//getCsound()->Message("CABBAGE: prepareToPlay() called by host\n");
+	//some hosts call prepareToPlay several times while loading or bouncing. Only a change that
+	//Csound can't follow without a recompile costs anything, a new block size on its own doesn't
+	if (!needsRecompile(sampleRate, samplesPerBlock))
+	{
+		CsoundPluginProcessor::prepareToPlay(sampleRate, samplesPerBlock);
+		return;
+	}
 
-	bool csoundRecompiled = false;
-	String jsonStateData;
+	//grab the current session so it can be put back once Csound has been recompiled
+	const ChannelSnapshot channels = snapshotChannels(getWidgetChannelNames());
+	std::string persistentData;
 
-	
-	//grab the current state so we can reinstate it if Csound is recompiled due to channel/SR changes..
 	if (getCsound())
 	{
 		auto** p = (CabbagePersistentData**)getCsound()->QueryGlobalVariable("cabbageData");
 
 		if (p != nullptr)
-		{
-			auto pdClass = *p;
-			jsonStateData = pdClass->data;
-		}
+			persistentData = (*p)->data;
 	}
 
-
 	CsoundPluginProcessor::prepareToPlay(sampleRate, samplesPerBlock);
 
-	if (sampleRate != samplingRate)
+	if (wasRecompiled())
 	{
-        samplingRate = sampleRate;
-        CsoundPluginProcessor::prepareToPlay(sampleRate, samplesPerBlock);
 		initAllCsoundChannels(cabbageWidgets);
-	}
+		restoreChannels(channels);
 
-	if (getCsound())
-	{
-		auto** p = (CabbagePersistentData**)getCsound()->QueryGlobalVariable("cabbageData");
-
-		if (p != nullptr)
+		if (getCsound())
 		{
-			auto pdClass = *p;
-			pdClass->data = jsonStateData.toStdString();
+			auto** p = (CabbagePersistentData**)getCsound()->QueryGlobalVariable("cabbageData");
+
+			if (p != nullptr)
+				(*p)->data = persistentData;
 		}
+
+		resetRecompiled();
 	}
+}
 
+StringArray CabbagePluginProcessor::getWidgetChannelNames()
+{
+	StringArray channelNames;
 
-	//some host call prepareToPlay multiple times, this will trigger Csound to recompile.
-    //when it does, we need to reinstate the current session state...
-	if (wasRecompiled())
+	for (int i = 0; i < cabbageWidgets.getNumChildren(); i++)
 	{
-		initAllCsoundChannels(cabbageWidgets);
-		setPluginState(hostStateData, "", true);
-		resetRecompiled();
-	}
+		const ValueTree widget = cabbageWidgets.getChild(i);
+		const var channels = CabbageWidgetData::getProperty(widget, CabbageIdentifierIds::channel);
 
-	
-	
+		if (channels.isArray())
+		{
+			for (int c = 0; c < channels.size(); c++)
+				channelNames.add(channels[c].toString());
+		}
+		else
+			channelNames.add(channels.toString());
+
+		if (CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::type) == CabbageWidgetTypes::xypad)
+		{
+			channelNames.add(CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::xchannel));
+			channelNames.add(CabbageWidgetData::getStringProp(widget, CabbageIdentifierIds::ychannel));
+		}
+	}
 
+	channelNames.removeEmptyStrings();
+	channelNames.removeDuplicates(false);
+	return channelNames;
 }
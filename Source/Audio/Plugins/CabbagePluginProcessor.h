@@ -23,9 +23,12 @@
 #include <utility>
 
 #include "CsoundPluginProcessor.h"
+#include "CabbagePluginStateData.h"
+#include "CabbagePreparseCache.h"
 #include "../../Widgets/CabbageWidgetData.h"
 #include "../../CabbageIds.h"
 #include "../../Widgets/CabbageXYPad.h"
+#include "../../Utilities/CabbageFileWatcher.h"
 
 class CabbagePluginParameter;
 
@@ -35,7 +38,8 @@ class CabbagePluginParameter;
 
 
 class CabbagePluginProcessor : public CsoundPluginProcessor,
-public Timer
+public Timer,
+private CabbageFileWatcher::Listener
 {
 public:
 
@@ -81,6 +85,8 @@ public:
     CachedValue<var> cachedValue;
     void getChannelDataFromCsound() override;
     void getIdentifierDataFromCsound() override;
+    //chnset changes are passed on to the host in gesture mode, even with the editor closed
+    bool hasGuiRefreshListeners() override  {   return getChnsetGestureMode() == 1;    }
 
     void setWidthHeight();
     CabbageWidgetIdentifiers** pd{};
@@ -89,17 +95,21 @@ public:
     std::string** globalPreset;
     std::string* preset;
     
-    int autoUpdateCount = 0;
     bool autoUpdateIsOn = false;
 
     
     //save and restore user plugin presets
     String addPluginPreset(String presetName, const String& fileName, bool remove);
+    //readValuesFromCsound takes numeric values from Csound's channels rather than from the widget data, which can be stale
+    nlohmann::ordered_json getPluginStateData(const String& presetName, bool readValuesFromCsound = false);
     void setPluginState(nlohmann::ordered_json j, const String presetName, bool hostState = false);
     void restorePluginPreset(String presetName, String filename);
     
     bool addImportFiles (StringArray& lineFromCsd);
     void parseCsdFile (StringArray& linesFromCsd);
+    void applyFormSettings (const ValueTree& form);
+    std::shared_ptr<const CabbagePreparseCache::Entry> createPreparseCacheEntry (const String& key, const File& inputFile, const File& expandedCsdFile) const;
+    void applyPreparseCacheEntry (const CabbagePreparseCache::Entry& entry);
     // use this instead of AudioProcessor::addParameter
     void addCabbageParameter(std::unique_ptr<CabbagePluginParameter> parameter);
     void createCabbageParameters();
@@ -115,6 +125,7 @@ public:
     String getPluginName() { return pluginName;  }
     void expandMacroText (String &line);
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+	StringArray getWidgetChannelNames();
 	void setCabbageParameter(String& channel, float value, ValueTree& wData);
     CabbagePluginParameter* getParameterForXYPad (StringRef name) const;
     //==============================================================================
@@ -126,6 +137,7 @@ public:
     void addXYAutomator (CabbageXYPad* xyPad, const ValueTree& wData);
     void enableXYAutomator (String name, bool enable, Line<float> dragLine);
     void disableXYAutomators();
+    void processAutomation (int numSamples) override;
     //==============================================================================
     void getStateInformation (MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
@@ -208,12 +220,38 @@ private:
     var macroNames;
     var macroStrings;
     OwnedArray<XYPadAutomator> xyAutomators;
+    SpinLock xyAutomatorLock;
 	int samplingRate = 44100;
 	int screenWidth{}, screenHeight{};
-    nlohmann::ordered_json hostStateData;
     OwnedArray<CabbagePluginParameter> parameters;
     Font customFont;
     File customFontFile;
+    SharedResourcePointer<CabbagePreparseCache> preparseCache;
+    std::shared_ptr<const CabbagePreparseCache::Entry> preparsedCsd;
+
+    //autoUpdate(), csdFile can be a temp file with the imported plants expanded, so the original is kept for reloading
+    void updateWatchedFiles();
+    void watchedFilesChanged (const Array<File>& changedFiles) override;
+    SharedResourcePointer<CabbageFileWatcher> fileWatcher;
+    File sourceCsdFile;
+
+    //each widget's identchannel, in the same order as cabbageWidgets
+    struct IdentChannel
+    {
+        static constexpr int maxMessageSize = 4096;
+
+        String name;
+        STRINGDAT* data = nullptr;
+        int* lock = nullptr;
+        HeapBlock<char> message { maxMessageSize, true };  //copied into under Csound's channel lock, so nothing is allocated while holding it
+    };
+
+    String readIdentChannel (int widgetIndex, const String& channelName);
+    bool identStringChannelExists (const String& channelName);
+    OwnedArray<IdentChannel> identChannels;
+    int identChannelsCsoundInstance = -1;
+    StringArray identStringChannels;
+    uint32 identStringChannelsListTime = 0;
  
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CabbagePluginProcessor)
 
@@ -280,6 +318,17 @@ public:
         }
     }
     
+    //used by the xypad automators, which write their channels on the audio thread themselves
+    void notifyHostOfValue(float newValue)
+    {
+        parameter->currentValue = parameter->range.convertFrom0to1(newValue);
+
+        if (isAutomatable)
+        {
+            parameter->sendValueChangedMessageToListeners(newValue);
+        }
+    }
+    
     void beginChangeGesture()
     {
         isPerformingGesture = true;
@@ -0,0 +1,369 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEPLUGINSTATEDATA_H_INCLUDED
+#define CABBAGEPLUGINSTATEDATA_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "../../Opcodes/json.hpp"
+#include <unordered_map>
+
+//==============================================================================
+// Compact, versioned binary encoding of the plugin state that hosts store in
+// their sessions. Layout is:
+//
+//  int32   magic ("CBST")
+//  int32   version
+//  cint    number of interned keys, followed by each key as a UTF-8 string
+//  value   the root value, see ValueType below
+//
+// Object keys (channel names for the most part) are written once in the key
+// table and referenced by index. Floats are written raw and long strings, such
+// as the data written by cabbageWriteStateData, are gzipped. Older sessions
+// were written as plain JSON text, so anything without the magic number is
+// handed back to the JSON parser by the processor.
+//==============================================================================
+class CabbagePluginStateData
+{
+public:
+    static constexpr int magicNumber = 0x54534243;
+    static constexpr int currentVersion = 1;
+    static constexpr size_t compressionThreshold = 512;
+    static constexpr int maxStringSize = 64 * 1024 * 1024;
+    static constexpr int maxCompressionRatio = 1032;
+
+    enum ValueType
+    {
+        nullValue = 0,
+        floatValue,
+        doubleValue,
+        intValue,
+        boolValue,
+        stringValue,
+        compressedStringValue,
+        objectValue,
+        arrayValue
+    };
+
+    static bool isBinaryState (const void* data, int sizeInBytes)
+    {
+        if (data == nullptr || sizeInBytes < 8)
+            return false;
+
+        return (int) ByteOrder::littleEndianInt (data) == magicNumber;
+    }
+
+    static void write (const nlohmann::ordered_json& state, MemoryBlock& destData)
+    {
+        Keys keys;
+        collectKeys (state, keys);
+
+        MemoryOutputStream out (destData, false);
+        out.writeInt (magicNumber);
+        out.writeInt (currentVersion);
+        out.writeCompressedInt ((int) keys.names.size());
+
+        for (const auto& name : keys.names)
+            writeUTF8 (out, name);
+
+        writeValue (out, state, keys);
+    }
+
+    static bool read (const void* data, int sizeInBytes, nlohmann::ordered_json& state)
+    {
+        if (! isBinaryState (data, sizeInBytes))
+            return false;
+
+        MemoryInputStream in (data, static_cast<size_t> (sizeInBytes), false);
+        in.readInt();
+
+        if (in.readInt() > currentVersion)
+            return false;
+
+        const int numKeys = in.readCompressedInt();
+
+        if (numKeys < 0 || numKeys > in.getNumBytesRemaining())
+            return false;
+
+        std::vector<std::string> keys;
+        keys.reserve ((size_t) numKeys);
+
+        for (int i = 0; i < numKeys; i++)
+        {
+            std::string key;
+            if (! readUTF8 (in, key))
+                return false;
+            keys.push_back (std::move (key));
+        }
+
+        return readValue (in, keys, state, 0);
+    }
+
+    // reads either the binary format or the JSON text written by older sessions,
+    // throws nlohmann::json::exception if the legacy text isn't valid JSON
+    static bool readState (const void* data, int sizeInBytes, nlohmann::ordered_json& state)
+    {
+        if (isBinaryState (data, sizeInBytes))
+            return read (data, sizeInBytes, state);
+
+        state = nlohmann::ordered_json::parse (MemoryInputStream (data, static_cast<size_t> (sizeInBytes), false).readString().toStdString());
+        return true;
+    }
+
+private:
+    struct Keys
+    {
+        std::vector<std::string> names;
+        std::unordered_map<std::string, int> indices;
+    };
+
+    static void collectKeys (const nlohmann::ordered_json& value, Keys& keys)
+    {
+        if (value.is_object())
+        {
+            for (auto it = value.begin(); it != value.end(); ++it)
+            {
+                if (keys.indices.find (it.key()) == keys.indices.end())
+                {
+                    keys.indices[it.key()] = (int) keys.names.size();
+                    keys.names.push_back (it.key());
+                }
+
+                collectKeys (it.value(), keys);
+            }
+        }
+        else if (value.is_array())
+        {
+            for (const auto& element : value)
+                collectKeys (element, keys);
+        }
+    }
+
+    static void writeUTF8 (OutputStream& out, const std::string& text)
+    {
+        out.writeCompressedInt ((int) text.size());
+        out.write (text.data(), text.size());
+    }
+
+    static bool readUTF8 (InputStream& in, std::string& text)
+    {
+        const int numBytes = in.readCompressedInt();
+
+        if (numBytes < 0 || numBytes > in.getNumBytesRemaining())
+            return false;
+
+        text.resize ((size_t) numBytes);
+        return numBytes == 0 || in.read (&text[0], numBytes) == numBytes;
+    }
+
+    static void writeString (OutputStream& out, const std::string& text)
+    {
+        if (text.size() > compressionThreshold)
+        {
+            MemoryBlock compressed;
+            {
+                MemoryOutputStream compressedStream (compressed, false);
+                GZIPCompressorOutputStream zipper (compressedStream);
+                zipper.write (text.data(), text.size());
+            }
+
+            if (compressed.getSize() < text.size())
+            {
+                out.writeByte ((char) compressedStringValue);
+                out.writeCompressedInt ((int) text.size());
+                out.writeCompressedInt ((int) compressed.getSize());
+                out.write (compressed.getData(), compressed.getSize());
+                return;
+            }
+        }
+
+        out.writeByte ((char) stringValue);
+        writeUTF8 (out, text);
+    }
+
+    static void writeValue (OutputStream& out, const nlohmann::ordered_json& value, const Keys& keys)
+    {
+        switch (value.type())
+        {
+            case nlohmann::json::value_t::object:
+                out.writeByte ((char) objectValue);
+                out.writeCompressedInt ((int) value.size());
+                for (auto it = value.begin(); it != value.end(); ++it)
+                {
+                    out.writeCompressedInt (keys.indices.at (it.key()));
+                    writeValue (out, it.value(), keys);
+                }
+                break;
+
+            case nlohmann::json::value_t::array:
+                out.writeByte ((char) arrayValue);
+                out.writeCompressedInt ((int) value.size());
+                for (const auto& element : value)
+                    writeValue (out, element, keys);
+                break;
+
+            case nlohmann::json::value_t::string:
+                writeString (out, value.get_ref<const std::string&>());
+                break;
+
+            case nlohmann::json::value_t::boolean:
+                out.writeByte ((char) boolValue);
+                out.writeBool (value.get<bool>());
+                break;
+
+            case nlohmann::json::value_t::number_integer:
+            case nlohmann::json::value_t::number_unsigned:
+                out.writeByte ((char) intValue);
+                out.writeInt64 (value.get<int64>());
+                break;
+
+            case nlohmann::json::value_t::number_float:
+            {
+                //widget values are floats, so most of these fit in 4 bytes without loss
+                const double number = value.get<double>();
+                if ((double) (float) number == number)
+                {
+                    out.writeByte ((char) floatValue);
+                    out.writeFloat ((float) number);
+                }
+                else
+                {
+                    out.writeByte ((char) doubleValue);
+                    out.writeDouble (number);
+                }
+                break;
+            }
+
+            case nlohmann::json::value_t::null:
+            case nlohmann::json::value_t::binary:
+            case nlohmann::json::value_t::discarded:
+            default:
+                out.writeByte ((char) nullValue);
+                break;
+        }
+    }
+
+    static bool readValue (InputStream& in, const std::vector<std::string>& keys, nlohmann::ordered_json& value, int depth)
+    {
+        if (depth > 64 || in.isExhausted())
+            return false;
+
+        switch (in.readByte())
+        {
+            case nullValue:
+                value = nullptr;
+                return true;
+
+            case floatValue:
+                value = in.readFloat();
+                return true;
+
+            case doubleValue:
+                value = in.readDouble();
+                return true;
+
+            case intValue:
+                value = in.readInt64();
+                return true;
+
+            case boolValue:
+                value = in.readBool();
+                return true;
+
+            case stringValue:
+            {
+                std::string text;
+                if (! readUTF8 (in, text))
+                    return false;
+                value = std::move (text);
+                return true;
+            }
+
+            case compressedStringValue:
+            {
+                const int originalSize = in.readCompressedInt();
+                const int compressedSize = in.readCompressedInt();
+
+                if (originalSize < 0 || compressedSize < 0 || compressedSize > in.getNumBytesRemaining())
+                    return false;
+
+                //deflate can't expand data by more than ~1032:1, so anything larger is corrupt
+                if (originalSize > maxStringSize || (int64) originalSize > (int64) compressedSize * maxCompressionRatio)
+                    return false;
+
+                MemoryBlock compressed;
+                in.readIntoMemoryBlock (compressed, compressedSize);
+                MemoryInputStream compressedStream (compressed, false);
+                GZIPDecompressorInputStream unzipper (compressedStream);
+
+                std::string text ((size_t) originalSize, '\0');
+                if (originalSize > 0 && unzipper.read (&text[0], originalSize) != originalSize)
+                    return false;
+
+                value = std::move (text);
+                return true;
+            }
+
+            case objectValue:
+            {
+                const int numItems = in.readCompressedInt();
+                if (numItems < 0 || numItems > in.getNumBytesRemaining())
+                    return false;
+
+                value = nlohmann::ordered_json::object();
+                for (int i = 0; i < numItems; i++)
+                {
+                    const int keyIndex = in.readCompressedInt();
+                    if (! isPositiveAndBelow (keyIndex, (int) keys.size()))
+                        return false;
+
+                    nlohmann::ordered_json item;
+                    if (! readValue (in, keys, item, depth + 1))
+                        return false;
+
+                    value[keys[(size_t) keyIndex]] = std::move (item);
+                }
+                return true;
+            }
+
+            case arrayValue:
+            {
+                const int numItems = in.readCompressedInt();
+                if (numItems < 0 || numItems > in.getNumBytesRemaining())
+                    return false;
+
+                value = nlohmann::ordered_json::array();
+                for (int i = 0; i < numItems; i++)
+                {
+                    nlohmann::ordered_json item;
+                    if (! readValue (in, keys, item, depth + 1))
+                        return false;
+
+                    value.push_back (std::move (item));
+                }
+                return true;
+            }
+
+            default:
+                return false;
+        }
+    }
+};
+
+#endif  // CABBAGEPLUGINSTATEDATA_H_INCLUDED
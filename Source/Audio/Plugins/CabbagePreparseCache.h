@@ -0,0 +1,122 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEPREPARSECACHE_H_INCLUDED
+#define CABBAGEPREPARSECACHE_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <unordered_map>
+
+//==============================================================================
+// Everything a CabbagePluginProcessor works out from its csd before Csound
+// gets involved: plant imports, macros, the widget tree and so on. None of
+// it changes from one instance to the next, so it's worked out once per
+// process and shared by every instance loading the same csd. Entries are
+// keyed on the csd's path and a hash of its text, and are dropped once any
+// imported file or font they were built from changes on disk, or the csd's
+// text changes and a new entry replaces them. The cache is
+// held through a SharedResourcePointer, so it goes away with the last
+// instance.
+//==============================================================================
+class CabbagePreparseCache
+{
+public:
+    struct Entry
+    {
+        ~Entry()
+        {
+            expandedCsdFile.deleteFile();
+        }
+
+        bool isUpToDate() const
+        {
+            for (const auto& dependency : dependencies)
+                if (dependency.file.getLastModificationTime() != dependency.lastModified)
+                    return false;
+
+            return true;
+        }
+
+        void addDependency (const File& file)
+        {
+            if (file.existsAsFile())
+                dependencies.add ({ file, file.getLastModificationTime() });
+        }
+
+        struct Dependency
+        {
+            File file;
+            Time lastModified;
+        };
+
+        String key;
+        Array<Dependency> dependencies;
+        ValueTree widgets;                  //instances take a deep copy of the children
+        File expandedCsdFile;               //csd with imported plant code inserted, the one Csound compiles
+        NamedValueSet macroText;
+        var macroNames, macroStrings;
+        int screenWidth = 0, screenHeight = 0;
+        bool autoUpdateIsOn = false;
+        Font customFont { 999 };
+        File customFontFile;
+    };
+
+    static String createKey (const File& csdFile, const String& csdText)
+    {
+        return csdFile.getFullPathName() + ":" + String::toHexString (csdText.hashCode64());
+    }
+
+    std::shared_ptr<const Entry> find (const String& key)
+    {
+        const ScopedLock sl (lock);
+        const auto it = entries.find (key.toStdString());
+
+        if (it == entries.end())
+            return nullptr;
+
+        if (! it->second->isUpToDate())
+        {
+            //anything still using the old entry keeps it alive
+            entries.erase (it);
+            return nullptr;
+        }
+
+        return it->second;
+    }
+
+    std::shared_ptr<const Entry> add (std::shared_ptr<const Entry> entry)
+    {
+        const ScopedLock sl (lock);
+
+        //only the latest text of each csd is kept, otherwise every edit and run in the IDE would add another entry
+        const String csdPath = entry->key.upToLastOccurrenceOf (":", true, false);
+
+        for (auto it = entries.begin(); it != entries.end();)
+            it = String (it->first).startsWith (csdPath) ? entries.erase (it) : std::next (it);
+
+        entries[entry->key.toStdString()] = entry;
+        return entry;
+    }
+
+private:
+    CriticalSection lock;
+    std::unordered_map<std::string, std::shared_ptr<const Entry>> entries;
+};
+
+#endif  // CABBAGEPREPARSECACHE_H_INCLUDED
@@ -0,0 +1,296 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CsoundMessageLog.h"
+#include <csound.h>
+
+//==============================================================================
+CsoundMessageLog::CsoundMessageLog()
+{
+    ringBuffer.allocate (ringBufferSize, true);
+    readBuffer.allocate (maxMessageSize, true);
+    thread->addTimeSliceClient (this);
+}
+
+CsoundMessageLog::~CsoundMessageLog()
+{
+    thread->removeTimeSliceClient (this);
+}
+
+//==============================================================================
+void CsoundMessageLog::addMessage (int attributes, const char* format, va_list args)
+{
+    char record[sizeof (MessageHeader) + maxMessageSize];
+    const int length = vsnprintf (record + sizeof (MessageHeader), maxMessageSize, format, args);
+
+    if (length <= 0)
+        return;
+
+    const MessageHeader header { attributes, jmin (length, maxMessageSize - 1) };
+    memcpy (record, &header, sizeof (MessageHeader));
+    const int recordSize = (int) sizeof (MessageHeader) + header.numBytes;
+
+    //the lock only keeps concurrent writers apart, the log thread never takes it
+    const SpinLock::ScopedLockType sl (writeLock);
+
+    if (fifo.getFreeSpace() < recordSize)
+    {
+        numDroppedMessages.store (numDroppedMessages.load() + 1);
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (recordSize, start1, size1, start2, size2);
+    memcpy (ringBuffer + start1, record, (size_t) size1);
+    if (size2 > 0)
+        memcpy (ringBuffer + start2, record + size1, (size_t) size2);
+    fifo.finishedWrite (size1 + size2);
+}
+
+//==============================================================================
+void CsoundMessageLog::setLogFile (const File& file)
+{
+    const ScopedLock sl (outputLock);
+    logFile = file;
+    logFileChanged = true;
+}
+
+String CsoundMessageLog::getNewOutput()
+{
+    String output;
+    const ScopedLock sl (outputLock);
+    std::swap (output, newOutput);
+    return output;
+}
+
+bool CsoundMessageLog::getSnapshot (String& text, int& lastVersionSeen)
+{
+    const ScopedLock sl (outputLock);
+
+    if (lastVersionSeen == snapshotVersion)
+        return false;
+
+    text = snapshot;
+    lastVersionSeen = snapshotVersion;
+    return true;
+}
+
+//==============================================================================
+int CsoundMessageLog::useTimeSlice()
+{
+    processMessages();
+    return 20;
+}
+
+void CsoundMessageLog::readFromRingBuffer (void* dest, int numBytes)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (numBytes, start1, size1, start2, size2);
+    memcpy (dest, ringBuffer + start1, (size_t) size1);
+    if (size2 > 0)
+        memcpy (static_cast<char*> (dest) + size1, ringBuffer + start2, (size_t) size2);
+    fifo.finishedRead (size1 + size2);
+}
+
+void CsoundMessageLog::processMessages()
+{
+    bool receivedMessages = false;
+
+    //records are committed whole, so once a header is ready its text is too
+    while (fifo.getNumReady() >= (int) sizeof (MessageHeader))
+    {
+        MessageHeader header;
+        readFromRingBuffer (&header, sizeof (MessageHeader));
+        readFromRingBuffer (readBuffer, header.numBytes);
+        receivedMessages = true;
+
+        //Csound often prints a line in several pieces
+        if (partialLine.isEmpty())
+            partialLineAttributes = header.attributes;
+
+        partialLine += String::fromUTF8 (readBuffer, header.numBytes);
+
+        for (int newLine = partialLine.indexOfChar ('\n'); newLine >= 0; newLine = partialLine.indexOfChar ('\n'))
+        {
+            handleLine (partialLineAttributes, partialLine.substring (0, newLine + 1));
+            partialLine = partialLine.substring (newLine + 1);
+            partialLineAttributes = header.attributes;
+        }
+    }
+
+    //don't hold on to an unterminated line once Csound has gone quiet
+    if (! receivedMessages && partialLine.isNotEmpty())
+    {
+        handleLine (partialLineAttributes, partialLine);
+        partialLine.clear();
+    }
+
+    const uint32 now = Time::getMillisecondCounter();
+
+    if (now - rateWindowStart >= 1000)
+    {
+        if (numRepeats > 0)
+            emit ("last message repeated " + String (numRepeats) + " times\n");
+        if (numSuppressedLines > 0)
+            emit ("[" + String (numSuppressedLines) + " lines of output suppressed]\n");
+
+        numRepeats = 0;
+        numSuppressedLines = 0;
+        numLinesThisSecond = 0;
+        rateWindowStart = now;
+    }
+
+    const int numDropped = numDroppedMessages.load();
+
+    if (numDropped != numDroppedReported)
+    {
+        emit ("[" + String (numDropped - numDroppedReported) + " Csound messages dropped]\n");
+        numDroppedReported = numDropped;
+    }
+
+    if (batch.isEmpty())
+        return;
+
+    writeToLogFile (batch);
+
+    {
+        const ScopedLock sl (outputLock);
+        appendBounded (newOutput, batch);
+        appendBounded (snapshot, batch);
+        ++snapshotVersion;
+    }
+
+    batch.clear();
+}
+
+void CsoundMessageLog::handleLine (int attributes, const String& line)
+{
+    const Severity severity = getSeverity (attributes);
+
+    if ((int) severity < minimumSeverity.load())
+        return;
+
+    if (line.contains ("midi channel") || line.contains ("is muted") || line.contains ("Score finished in csoundPerformKsmps()"))
+        return;
+
+    if (line == lastLine)
+    {
+        ++numRepeats;
+        return;
+    }
+
+    if (numRepeats > 0)
+    {
+        emit ("last message repeated " + String (numRepeats) + " times\n");
+        numRepeats = 0;
+    }
+
+    lastLine = line;
+
+    //errors and warnings always get through, everything else is rate limited
+    if (severity == informationSeverity && ++numLinesThisSecond > maxLinesPerSecond)
+    {
+        ++numSuppressedLines;
+        return;
+    }
+
+    emit (line);
+}
+
+void CsoundMessageLog::emit (const String& text)
+{
+    batch += text;
+}
+
+void CsoundMessageLog::writeToLogFile (const String& text)
+{
+    File file;
+    bool fileChanged;
+
+    {
+        const ScopedLock sl (outputLock);
+        file = logFile;
+        fileChanged = logFileChanged;
+        logFileChanged = false;
+    }
+
+    if (fileChanged)
+        logStream.reset();
+
+    if (file == File())
+    {
+        writeToLogger (text);
+        return;
+    }
+
+    if (logStream != nullptr && logStream->getPosition() + text.getNumBytesAsUTF8() > maxLogFileSize)
+    {
+        //keep one old log around, the next rollover replaces it
+        logStream.reset();
+        const File backup = file.getSiblingFile (file.getFileNameWithoutExtension() + "_old" + file.getFileExtension());
+        backup.deleteFile();
+        file.moveFileTo (backup);
+    }
+
+    if (logStream == nullptr)
+    {
+        logStream = std::make_unique<FileOutputStream> (file);
+
+        if (logStream->failedToOpen())
+        {
+            logStream.reset();
+            writeToLogger (text);
+            return;
+        }
+
+        logStream->writeText ("Cabbage Log.. " + Time::getCurrentTime().toString (true, true) + "\n", false, false, nullptr);
+    }
+
+    logStream->writeText (text, false, false, nullptr);
+    logStream->flush();
+}
+
+void CsoundMessageLog::writeToLogger (const String& text)
+{
+    //the IDE's logger is a component, so it's only written to from the message thread
+    MessageManager::callAsync ([line = text.trimCharactersAtEnd ("\n")] { Logger::writeToLog (line); });
+}
+
+CsoundMessageLog::Severity CsoundMessageLog::getSeverity (int attributes)
+{
+    switch (attributes & CSOUNDMSG_TYPE_MASK)
+    {
+        case CSOUNDMSG_ERROR:   return errorSeverity;
+        case CSOUNDMSG_WARNING: return warningSeverity;
+        default:                return informationSeverity;
+    }
+}
+
+void CsoundMessageLog::appendBounded (String& dest, const String& text)
+{
+    dest += text;
+    const int length = dest.length();
+
+    if (length > maxOutputSize)
+    {
+        //drop whole lines from the front where possible
+        const int newLine = dest.indexOfChar (length - maxOutputSize, '\n');
+        dest = dest.substring (newLine >= 0 ? newLine + 1 : length - maxOutputSize);
+    }
+}
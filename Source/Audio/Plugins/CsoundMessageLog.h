@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CSOUNDMESSAGELOG_H_INCLUDED
+#define CSOUNDMESSAGELOG_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <cstdarg>
+
+//==============================================================================
+class CsoundMessageLogThread : public TimeSliceThread
+{
+public:
+    CsoundMessageLogThread() : TimeSliceThread ("Csound message log")
+    {
+        startThread (2);
+    }
+
+    ~CsoundMessageLogThread() override
+    {
+        stopThread (1000);
+    }
+};
+
+//==============================================================================
+// Collects Csound's console output. Csound's message callback formats each
+// message into a preallocated ring buffer and returns, so printing from the
+// performance thread never touches the heap, the UI or the disk. A shared
+// background thread then splits the messages into lines, filters and
+// de-duplicates them, limits how many ordinary lines get through per second,
+// and writes the result to the log file and to a bounded output buffer that
+// the consoles read from. Messages that don't fit in the ring are counted and
+// reported rather than waited on.
+//==============================================================================
+class CsoundMessageLog : public TimeSliceClient
+{
+public:
+    static constexpr int ringBufferSize = 256 * 1024;
+    static constexpr int maxMessageSize = 2048;
+    static constexpr int maxOutputSize = 64 * 1024;
+    static constexpr int maxLinesPerSecond = 200;
+    static constexpr int64 maxLogFileSize = 4 * 1024 * 1024;
+
+    enum Severity
+    {
+        informationSeverity = 0,
+        warningSeverity,
+        errorSeverity
+    };
+
+    CsoundMessageLog();
+    ~CsoundMessageLog() override;
+
+    //called from Csound's message callback on whichever thread printed
+    void addMessage (int attributes, const char* format, va_list args);
+
+    //Csound output is written here, and rolled over to a single backup once it grows past maxLogFileSize
+    void setLogFile (const File& file);
+
+    //text logged since the last call, at most maxOutputSize characters of it
+    String getNewOutput();
+
+    //the most recent maxOutputSize characters of output, returns false if nothing has changed since lastVersionSeen
+    bool getSnapshot (String& text, int& lastVersionSeen);
+
+    int getNumDroppedMessages() const   {   return numDroppedMessages.load();   }
+
+    //lines below this severity are dropped before they reach the consoles or the log file
+    void setMinimumSeverity (Severity severity)     {   minimumSeverity.store ((int) severity);   }
+    Severity getMinimumSeverity() const             {   return (Severity) minimumSeverity.load();   }
+
+    int useTimeSlice() override;
+
+private:
+    struct MessageHeader
+    {
+        int attributes;
+        int numBytes;
+    };
+
+    void readFromRingBuffer (void* dest, int numBytes);
+    void processMessages();
+    void handleLine (int attributes, const String& line);
+    void emit (const String& text);
+    void writeToLogFile (const String& text);
+    static void appendBounded (String& dest, const String& text);
+    static Severity getSeverity (int attributes);
+    static void writeToLogger (const String& text);
+
+    SharedResourcePointer<CsoundMessageLogThread> thread;
+
+    //writer side
+    HeapBlock<char> ringBuffer;
+    AbstractFifo fifo { ringBufferSize };
+    SpinLock writeLock;
+    std::atomic<int> numDroppedMessages { 0 };
+    std::atomic<int> minimumSeverity { informationSeverity };
+
+    //sink side, only touched on the log thread
+    HeapBlock<char> readBuffer;
+    String partialLine, lastLine, batch;
+    int partialLineAttributes = 0;
+    int numRepeats = 0;
+    int numLinesThisSecond = 0, numSuppressedLines = 0;
+    int numDroppedReported = 0;
+    uint32 rateWindowStart = 0;
+    std::unique_ptr<FileOutputStream> logStream;
+
+    //shared with the message thread
+    CriticalSection outputLock;
+    File logFile;
+    bool logFileChanged = false;
+    String newOutput, snapshot;
+    int snapshotVersion = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CsoundMessageLog)
+};
+
+#endif  // CSOUNDMESSAGELOG_H_INCLUDED
@@ -51,8 +51,6 @@ csdFile (selectedCsdFile)
 #else  
     numCsoundOutputChannels = getTotalNumOutputChannels();
     CabbageUtilities::debug("Constructor - Requested output channels:", numCsoundOutputChannels);
-    
-    backgroundThread.startThread();
 
 #endif
 
@@ -61,6 +59,7 @@ csdFile (selectedCsdFile)
 CsoundPluginProcessor::~CsoundPluginProcessor()
 {
 	resetCsound();
+    threadBudget->release (this);
 }
 
 void CsoundPluginProcessor::resetCsound()
@@ -85,47 +84,77 @@ void CsoundPluginProcessor::resetCsound()
 //==============================================================================
 void CsoundPluginProcessor::startRecording(const File& file, int bitDepth)
 {
-    stopRecording();
+    CabbageAudioRecorder::Options options;
+    options.file = file;
+    options.bitDepth = bitDepth;
+    startRecording (options);
+}
 
-    if (samplingRate > 0)
-    {
-        // Create an OutputStream to write to our destination file...
-        file.deleteFile();
+bool CsoundPluginProcessor::startRecording (const CabbageAudioRecorder::Options& options)
+{
+    if (! armRecording (options))
+        return false;
 
-        if (auto fileStream = std::unique_ptr<FileOutputStream> (file.createOutputStream()))
-        {
-            // Now create a WAV writer object that writes to our output stream...
-            WavAudioFormat wavFormat;
+    recorder.startRecording();
+    return true;
+}
 
-            if (auto writer = wavFormat.createWriterFor (fileStream.get(), samplingRate, numCsoundOutputChannels, bitDepth, {}, 0))
-            {
-                fileStream.release(); // (passes responsibility for deleting the stream to the writer object that is now using it)
+bool CsoundPluginProcessor::armRecording (const CabbageAudioRecorder::Options& options)
+{
+    Array<CabbageAudioRecorder::StemSource> sources;
 
-                // Now we'll create one of these helper objects which will act as a FIFO buffer, and will
-                // write the data to disk on our background thread.
-                threadedWriter.reset (new AudioFormatWriter::ThreadedWriter (writer, backgroundThread, 32768));
+    if (options.recordMainOutputs)
+    {
+        CabbageAudioRecorder::StemSource mainOutputs;
+        mainOutputs.numChannels = numCsoundOutputChannels;
+        sources.add (mainOutputs);
+    }
 
-                // And now, swap over our active writer pointer so that the audio callback will start using it..
-                const ScopedLock sl (writerLock);
-                activeWriter = threadedWriter.get();
+    if (options.recordOutputBuses)
+    {
+        for (int busIndex = 0; busIndex < getBusCount (false); busIndex++)
+        {
+            if (getBus (false, busIndex)->isEnabled())
+            {
+                CabbageAudioRecorder::StemSource bus;
+                bus.name = "bus" + String (busIndex + 1);
+                bus.firstChannel = getChannelIndexInProcessBlockBuffer (false, busIndex, 0);
+                bus.numChannels = getBus (false, busIndex)->getNumberOfChannels();
+                sources.add (bus);
             }
         }
     }
-}
 
-void CsoundPluginProcessor::stopRecording()
-{
-    // First, clear this pointer to stop the audio callback from using our writer object..
+    //channel pointers stay valid until Csound is recompiled, which stops the recording first
+    for (const auto& channelName : options.csoundChannels)
     {
-        const ScopedLock sl (writerLock);
-        activeWriter = nullptr;
+        MYFLT* channelData = nullptr;
+
+        if (csound != nullptr && csdCompiledWithoutError()
+            && csound->GetChannelPtr (channelData, channelName.toUTF8(), CSOUND_AUDIO_CHANNEL | CSOUND_OUTPUT_CHANNEL) == CSOUND_SUCCESS)
+        {
+            CabbageAudioRecorder::StemSource channel;
+            channel.name = channelName;
+            channel.numChannels = 1;
+            channel.csoundChannel = channelData;
+            channel.gain = cs_scale != 0 ? float (1.0 / cs_scale) : 1.f;
+            channel.sampleRate = csound->GetSr();
+            sources.add (channel);
+        }
     }
 
-    // Now we can delete the writer object. It's done in this order because the deletion could
-    // take a little time while remaining data gets flushed to disk, so it's best to avoid blocking
-    // the audio callback while this happens.
+    return recorder.arm (options, sources, samplingRate);
+}
 
-    threadedWriter.reset();
+void CsoundPluginProcessor::startRecording()
+{
+    recorder.startRecording();
+}
+
+void CsoundPluginProcessor::stopRecording()
+{
+    //flushes whatever is left in the FIFOs and closes the files
+    recorder.stop();
 }
 //==============================================================================
 void CsoundPluginProcessor::destroyCsoundGlobalVars()
@@ -193,13 +222,18 @@ void CsoundPluginProcessor::createCsoundGlobalVars(const ValueTree& cabbageData)
 //==============================================================================
 bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File filePath, int sr, bool debugMode)
 {
-    
+    //Csound channel stems point into the instance that's about to be replaced
+    stopRecording();
+
     csdFile = currentCsdFile;
     String csdFileText;
     StringArray csdLines;
 
     csdLines.addLines(csdFile.loadFileAsString());
     csdFileText = csdFile.loadFileAsString();
+    requestedCsoundThreads = 1;
+    ksmpsRangeMin = ksmpsRangeMax = 0;
+    requestedOversampling = 1;
    
     for (auto line : csdLines)
     {
@@ -239,6 +273,11 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File file
             if (CabbageWidgetData::getNumProp(temp, CabbageIdentifierIds::latency) == -1) {
                 preferredLatency = -1;
             }
+
+            requestedCsoundThreads = int(CabbageWidgetData::getNumProp(temp, CabbageIdentifierIds::threads));
+            ksmpsRangeMin = int(CabbageWidgetData::getNumProp(temp, CabbageIdentifierIds::ksmpsmin));
+            ksmpsRangeMax = int(CabbageWidgetData::getNumProp(temp, CabbageIdentifierIds::ksmpsmax));
+            requestedOversampling = int(CabbageWidgetData::getNumProp(temp, CabbageIdentifierIds::oversampling));
         }
 
     }
@@ -269,9 +308,11 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File file
     
     Logger::writeToLog(String::formatted("Resetting csound ...\ncsound = 0x%p", csound.get()));
 
-    //reset Csound in case it is hanging around from a previous run
+    //reset Csound in case it is hanging around from a previous run, events queued for it go with it
     resetCsound();
+    scoreEvents.clear();
 	csound = std::make_unique<Csound> ();
+    ++csoundInstanceNumber;
     
 	csdFilePath = filePath;
 	//csdFilePath.setAsCurrentWorkingDirectory();
@@ -381,6 +422,7 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File file
 
     csnd::plugin<CabbageMidiReader>((csnd::Csound*) getCsound()->GetCsound(), "cabbageMidiFileReader", "k[]k[]k[]k[]kk", "Sikkkko", csnd::thread::ik);
     csnd::plugin<CabbageMidiFileInfo>((csnd::Csound*) getCsound()->GetCsound(), "cabbageMidiFileInfo", "", "S", csnd::thread::i);
+    csnd::plugin<CabbageFileReader>((csnd::Csound*) getCsound()->GetCsound(), "cabbageFileReader", "m", "Skoo", csnd::thread::ia);
     csnd::plugin<CabbageMidiListener>((csnd::Csound*)getCsound()->GetCsound(), "cabbageMidiListener", "k[]k[]k[]k", "O", csnd::thread::ik);
     csnd::plugin<CabbageMidiSender>((csnd::Csound*)getCsound()->GetCsound(), "cabbageMidiSender", "", "", csnd::thread::i);
     
@@ -409,7 +451,7 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File file
     csnd::plugin<CabbageBTOpcode>((csnd::Csound*) getCsound()->GetCsound(), "cabbageBleutooth", "k", "S", csnd::thread::k);
 #endif
     
-	csound->CreateMessageBuffer(0);
+	csound->SetMessageCallback(messageCallback);
 	csound->SetExternalMidiInOpenCallback(OpenMidiInputDevice);
 	csound->SetExternalMidiReadCallback(ReadMidiData);
 	csound->SetExternalMidiOutOpenCallback(OpenMidiOutputDevice);
@@ -471,9 +513,29 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File file
 
 	csoundParams->sample_rate_override = requestedSampleRate>0 ? requestedSampleRate : sr;
 
+    //when oversampling Csound has to run at a multiple of the host rate, whatever the header says
+    oversamplingFactor = getRequestedOversamplingFactor();
+
+    if (oversamplingFactor > 1)
+        csoundParams->sample_rate_override = sr * oversamplingFactor;
+
+    //with ksmpsRange() the csd's ksmps is only a starting point, once the host's block size is known we pick our own
+    if (ksmpsRangeMax > 0 && hostBlockSize > 0 && !debugMode)
+        csoundParams->ksmps_override = chooseKsmpsForBlockSize(hostBlockSize * oversamplingFactor, ksmpsRangeMin, ksmpsRangeMax);
+
     if(preferredLatency == -1)
         csoundParams->ksmps_override = 1;
 
+    //threads are negotiated with every other instance in the process
+    int threadsWanted = csoundThreadsOverride >= 0 ? csoundThreadsOverride : requestedCsoundThreads;
+    const int ksmps = csoundParams->ksmps_override > 0 ? csoundParams->ksmps_override : requestedKsmpsRate;
+
+    if (debugMode || singleThreadedFallback || (ksmps > 0 && ksmps < CsoundThreadBudget::minKsmpsForThreads))
+        threadsWanted = 1;
+
+    numCsoundThreads = threadBudget->acquire(this, threadsWanted);
+    csoundParams->number_of_threads = numCsoundThreads;
+
 	csound->SetParams(csoundParams.get());
     
 //#ifdef CabbagePro
@@ -486,6 +548,15 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File file
         compileCsdFile(csdFile);
     }
 
+    //Csound's parallel compiler rejects some orchestras that compile fine on a single thread
+    if (!csdCompiledWithoutError() && numCsoundThreads > 1)
+    {
+        csound->Message("CABBAGE: Compiling for multiple threads failed, trying again with one thread\n");
+        singleThreadedFallback = true;
+        const bool compiled = setupAndCompileCsound(currentCsdFile, filePath, sr, debugMode);
+        singleThreadedFallback = false;
+        return compiled;
+    }
 
 
 	if (csdCompiledWithoutError())
@@ -497,6 +568,12 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File file
 		csndIndex = csound->GetKsmps();
         const String version = String("CABBAGE: Version:")+ProjectInfo::versionString+String("\n");
         csound->Message(version.toRawUTF8());
+
+        if (numCsoundThreads > 1)
+            csound->Message(String("CABBAGE: Performing with " + String(numCsoundThreads) + " threads\n").toRawUTF8());
+
+        if (ksmpsRangeMax > 0 && hostBlockSize > 0)
+            csound->Message(String("CABBAGE: Using ksmps=" + String(csdKsmps) + " for a host block size of " + String(hostBlockSize) + "\n").toRawUTF8());
         
 #if CabbagePro
         const String encryptedOrcCode = Encrypt::decode(csdFile, "orc");
@@ -512,6 +589,7 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File file
 	else
 		CabbageUtilities::debug("Csound could not compile your file?");
 
+    updateGuiRefreshTimer();
     return csdCompiledWithoutError();
 
 }
@@ -520,8 +598,7 @@ bool CsoundPluginProcessor::setupAndCompileCsound(File currentCsdFile, File file
 void CsoundPluginProcessor::createFileLogger (File csoundFile)
 {
     String logFileName = csoundFile.getParentDirectory().getFullPathName() + String ("/") + csoundFile.getFileNameWithoutExtension() + String ("_Log.txt");
-    fileLogger.reset (new FileLogger (File (logFileName), String ("Cabbage Log..")));
-    Logger::setCurrentLogger (fileLogger.get());
+    messageLog.setLogFile (File (logFileName));
 }
 //==============================================================================
 void CsoundPluginProcessor::resetFilebuttons(ValueTree cabbageData)
@@ -749,7 +826,8 @@ void CsoundPluginProcessor::initAllCsoundChannels (ValueTree cabbageData)
 
     csound->SetChannel("IS_BYPASSED", 0.0);
     //csdFilePath.setAsCurrentWorkingDirectory();
-    csound->SetChannel("HOST_BUFFER_SIZE", csdKsmps);
+    csound->SetChannel("HOST_BUFFER_SIZE", hostBlockSize > 0 ? hostBlockSize : csdKsmps);
+    csound->SetChannel("CURRENT_KSMPS", csdKsmps);
     csound->SetChannel("HOME_FOLDER_UID", File::getSpecialLocation (File::userHomeDirectory).getFileIdentifier());
 
     time_t seconds_past_epoch = time(nullptr);
@@ -909,38 +987,34 @@ void CsoundPluginProcessor::addMacros (String& csdText)
 }
 
 //==============================================================================
-void CsoundPluginProcessor::createMatrixEventSequencer(int rows, int cols, String channel)
+bool CsoundPluginProcessor::createMatrixEventSequencer(int rows, int cols, String channel, bool stepsAreRows)
 {
-    auto* matrix = new MatrixEventSequencer(channel);
+    //sequencers keep playing while the editor is closed, so a reopened widget picks up the existing one
+    if (auto* existing = getMatrixEventSequencer(channel))
+        if (existing->numColumns == cols && existing->numRows == rows && existing->stepsAreRows == stepsAreRows)
+            return false;
 
-    for (int i = 0 ; i < cols ; i++)
-    {
-        matrix->events.add (new StringArray());
+    auto* matrix = new CabbageMatrixEventSequencer(channel, cols, rows, stepsAreRows);
+    const SpinLock::ScopedLockType sl(matrixEventSequencerLock);
 
-        for ( int y = 0 ; y < rows ; y++)
-        {
-            matrix->events[i]->add(" ");
-        }
-    }
+    if (auto* existing = matrixEventSequencersByChannel[channel])
+        matrixEventSequencers.removeObject(existing);
 
     matrixEventSequencers.add(matrix);
-	numMatrixEventSequencers = matrixEventSequencers.size();
-
+    matrixEventSequencersByChannel.set(channel, matrix);
+    numMatrixEventSequencers = matrixEventSequencers.size();
+    return true;
+}
 
+CabbageMatrixEventSequencer* CsoundPluginProcessor::getMatrixEventSequencer(const String& channel)
+{
+    return matrixEventSequencersByChannel[channel];
 }
 
-void CsoundPluginProcessor::setMatrixEventSequencerCellData(int col, int row, const String& channel, String data)
+void CsoundPluginProcessor::setMatrixEventSequencerCellData(int col, int row, const String& channel, String data, const String& displayText)
 {
-	if (numMatrixEventSequencers > 0)
-	{
-		for (auto matrixEventSequencer : matrixEventSequencers)
-		{
-			if (matrixEventSequencer->channel == channel)
-			{
-				matrixEventSequencer->setEventString(col, row, data);
-			}
-		}
-	}
+    if (auto* matrixEventSequencer = getMatrixEventSequencer(channel))
+        matrixEventSequencer->setCell(col, row, data, displayText);
 }
 
 //==============================================================================
@@ -998,26 +1072,22 @@ const Array<float, CriticalSection> CsoundPluginProcessor::getTableFloats (int t
 }
 
 //==============================================================================
+void CsoundPluginProcessor::messageCallback (CSOUND* csound, int attributes, const char* format, va_list args)
+{
+    if (auto* ud = static_cast<CsoundPluginProcessor*> (csoundGetHostData (csound)))
+        ud->messageLog.addMessage (attributes, format, args);
+}
+
 String CsoundPluginProcessor::getCsoundOutput()
 {
     if (csound!=nullptr)
     {
-        const int messageCnt = csound->GetMessageCnt();
-        csoundOutput = "";
+        //filtering and logging has already been done on the message log's thread
+        csoundOutput = messageLog.getNewOutput();
 
-        if (messageCnt == 0)
+        if (csoundOutput.isEmpty())
             return csoundOutput;
 
-        while (csound->GetMessageCnt() > 0)
-        {
-            String message = CharPointer_UTF8(csound->GetFirstMessage());
-            if(!message.contains("midi channel") && !message.contains("is muted") && !message.contains("Score finished in csoundPerformKsmps()"))
-                csoundOutput += message;
-            csound->PopFirstMessage();
-        }
-
-        Logger::writeToLog (csoundOutput);
-
         if (disableLogging)
             this->suspendProcessing (true);
 
@@ -1088,6 +1158,8 @@ void CsoundPluginProcessor::changeProgramName (int index, const String& newName)
 //==============================================================================
 void CsoundPluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    hostBlockSize = samplesPerBlock;
+
     if(getCsound()!= nullptr)
         csound->SetChannel("HOST_BUFFER_SIZE", samplesPerBlock);
 #if Cabbage_IDE_Build == 0
@@ -1117,30 +1189,133 @@ void CsoundPluginProcessor::prepareToPlay (double sampleRate, int samplesPerBloc
 
     CabbageUtilities::debug("CsoundPluginProcessor::prepareToPlay - Sampling rate:", samplingRate);
 
-    //weird thing in FL Studio where outputs is 0 at some point, causing Csound to recompile, causing issues with channels
-    if (outputs != 0)
+    const bool recompile = needsRecompile(sampleRate, samplesPerBlock);
+
+    if (recompile)
     {
-        if (((samplingRate != sampleRate))
-#if ! JucePlugin_IsSynth
-            || numCsoundInputChannels != inputs
-#endif
-            || numCsoundOutputChannels != outputs)
-        {
-            //if sampling rate is other than default or has been changed, recompile..
-            samplingRate = (double)sampleRate;
-            //the problem here is channels have already been instantiated, so no change triggers will take place..
-            CabbageUtilities::debug("CsoundPluginProcessor::prepareToPlay - calling setupAndCompileCsound()");
-            setupAndCompileCsound(csdFile, csdFilePath, samplingRate);
-            recompiledOnPrepareToPlay = true;
+        //if sampling rate is other than default or has been changed, recompile..
+        samplingRate = (double)sampleRate;
+        //the problem here is channels have already been instantiated, so no change triggers will take place..
+        CabbageUtilities::debug("CsoundPluginProcessor::prepareToPlay - calling setupAndCompileCsound()");
+        setupAndCompileCsound(csdFile, csdFilePath, samplingRate);
+        recompiledOnPrepareToPlay = true;
+    }
+
+    if (oversamplingFactor > 1)
+    {
+        //hosts often call this again with nothing but a new block size, the filters can be kept for that
+        const int numChannels = jmax(getTotalNumInputChannels(), getTotalNumOutputChannels(), 1);
 
+        if (oversampler == nullptr || recompile || oversamplerNumChannels != numChannels
+            || (int) oversampler->getOversamplingFactor() != oversamplingFactor)
+        {
+            oversampler = std::make_unique<dsp::Oversampling<float>>((size_t) numChannels, (size_t) roundToInt(std::log2(oversamplingFactor)),
+                                                                     dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+            oversamplerNumChannels = numChannels;
         }
+
+        oversampler->initProcessing((size_t) samplesPerBlock);
     }
+    else
+        oversampler = nullptr;
+
 #if Cabbage_IDE_Build == 0
+    //ksmps counts samples at Csound's rate, the host wants them at its own
     if (preferredLatency == -1)
-        this->setLatencySamples(0);
-    else
-	    this->setLatencySamples(preferredLatency == 0 ? csound->GetKsmps() : preferredLatency);
+        this->setLatencySamples(getOversamplingLatency());
+	else
+	    this->setLatencySamples((preferredLatency == 0 ? csound->GetKsmps() / oversamplingFactor : preferredLatency) + getOversamplingLatency());
+#endif
+}
+
+bool CsoundPluginProcessor::needsRecompile (double sampleRate, int samplesPerBlock)
+{
+    //weird thing in FL Studio where outputs is 0 at some point, causing Csound to recompile, causing issues with channels
+    if (getTotalNumOutputChannels() == 0)
+        return false;
+
+    return samplingRate != sampleRate
+#if ! JucePlugin_IsSynth
+        || numCsoundInputChannels != getTotalNumInputChannels()
 #endif
+        || numCsoundOutputChannels != getTotalNumOutputChannels()
+        || getRequestedOversamplingFactor() != oversamplingFactor
+        || (ksmpsRangeMax > 0 && preferredLatency != -1 && csdCompiledWithoutError()
+            && chooseKsmpsForBlockSize(samplesPerBlock * getRequestedOversamplingFactor(), ksmpsRangeMin, ksmpsRangeMax) != csdKsmps);
+}
+
+CsoundPluginProcessor::ChannelSnapshot CsoundPluginProcessor::snapshotChannels (const StringArray& channelNames)
+{
+    ChannelSnapshot snapshot;
+
+    if (csound == nullptr || !csdCompiledWithoutError())
+        return snapshot;
+
+    controlChannelInfo_t* channelList = nullptr;
+    const int numChannels = csound->ListChannels(channelList);
+
+    for (int i = 0; i < numChannels; i++)
+    {
+        //string channels always follow their widget's properties, initAllCsoundChannels() takes care of those
+        if ((channelList[i].type & CSOUND_CHANNEL_TYPE_MASK) != CSOUND_CONTROL_CHANNEL)
+            continue;
+
+        const String name (channelList[i].name);
+
+        if (channelNames.contains(name))
+            snapshot.controlChannels.add({ name, csound->GetChannel(channelList[i].name) });
+    }
+
+    if (channelList != nullptr)
+        csound->DeleteChannelList(channelList);
+
+    return snapshot;
+}
+
+void CsoundPluginProcessor::restoreChannels (const ChannelSnapshot& snapshot)
+{
+    if (csound == nullptr || !csdCompiledWithoutError())
+        return;
+
+    for (const auto& channel : snapshot.controlChannels)
+        csound->SetChannel(channel.first.toUTF8(), channel.second);
+}
+
+int CsoundPluginProcessor::getRequestedOversamplingFactor() const
+{
+    const int factor = oversamplingOverride > 0 ? oversamplingOverride : requestedOversampling;
+    return factor >= 8 ? 8 : factor >= 4 ? 4 : factor >= 2 ? 2 : 1;
+}
+
+int CsoundPluginProcessor::getOversamplingLatency() const
+{
+    return oversampler != nullptr ? roundToInt(oversampler->getLatencyInSamples()) : 0;
+}
+
+void CsoundPluginProcessor::setOversamplingFactor (int factor)
+{
+    oversamplingOverride = factor;
+
+    if (getSampleRate() <= 0 || getRequestedOversamplingFactor() == oversamplingFactor)
+        return;
+
+    //prepareToPlay() carries the session's channel values over the recompile
+    suspendProcessing(true);
+    prepareToPlay(getSampleRate(), getBlockSize());
+    suspendProcessing(false);
+}
+
+int CsoundPluginProcessor::chooseKsmpsForBlockSize (int blockSize, int minKsmps, int maxKsmps)
+{
+    minKsmps = jmax(1, minKsmps);
+    maxKsmps = jmax(minKsmps, maxKsmps);
+
+    for (int ksmps = jmin(maxKsmps, blockSize); ksmps >= minKsmps; ksmps--)
+        if (blockSize % ksmps == 0)
+            return ksmps;
+
+    //nothing in the range divides the block, k-cycles will drift against it whatever we pick
+    return jlimit(minKsmps, maxKsmps, blockSize);
 }
 
 void CsoundPluginProcessor::releaseResources()
@@ -1150,7 +1325,7 @@ void CsoundPluginProcessor::releaseResources()
 }
 
 
-void CsoundPluginProcessor::handleAsyncUpdate()
+void CsoundPluginProcessor::updateGuiFromCsound()
 {
     if(polling == 1)
     {
@@ -1169,6 +1344,28 @@ void CsoundPluginProcessor::handleAsyncUpdate()
     
 }
 
+//==============================================================================
+double CsoundPluginProcessor::getGuiRefreshRateInHz() const
+{
+    if (guiRefreshRateIsInHz)
+        return jlimit (1.0, 120.0, (double) guiRefreshRate);
+
+    //legacy guiRefresh values count k-cycles, convert them to a wall-clock rate for the current kr
+    const double kr = csound != nullptr ? csound->GetKr() : 44100.0 / 64.0;
+    return jlimit (1.0, 60.0, kr / jmax (1, guiRefreshRate));
+}
+
+void CsoundPluginProcessor::updateGuiRefreshTimer()
+{
+    //guiMode("queue") widgets are updated from the processor's own timer
+    const bool isNeeded = polling != 0 && csdCompiledWithoutError() && (editorShowing || hasGuiRefreshListeners());
+
+    if (isNeeded)
+        guiRefreshScheduler.startTimerHz (roundToInt (getGuiRefreshRateInHz()));
+    else
+        guiRefreshScheduler.stopTimer();
+}
+
 void CsoundPluginProcessor::sendHostDataToCsound()
 {
 //    if (CabbageUtilities::getTarget() != CabbageUtilities::TargetTypes::IDE)
@@ -1200,24 +1397,15 @@ void CsoundPluginProcessor::performCsoundKsmps()
     if(csound == nullptr)
         return;
     
+    processAutomation(csdKsmps);
+    scoreEvents.sendQueuedEvents(*csound);
     result = csound->PerformKsmps();
 
     if (result == 0)
     {
-        //slow down calls to these functions, no need for them to be firing at k-rate
-        if(polling != 0)
-        {
-            if (guiCycles > guiRefreshRate)
-            {
-                guiCycles = 0;
-                triggerAsyncUpdate();
-            }
-            else
-                ++guiCycles;
-        }
-        else{
-            //triggerAsyncUpdate();
-        }
+        //the GUI picks this up on its own timer, only this thread ever writes it
+        ksmpsPerformed.store (ksmpsPerformed.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        recorder.processCsoundChannels (csdKsmps);
         //trigger any Csound score event on each k-boundary
         //triggerCsoundEvents();
         sendHostDataToCsound();
@@ -1280,6 +1468,50 @@ template< typename Type >
 void CsoundPluginProcessor::processSamples(AudioBuffer< Type >& buffer, MidiBuffer& midiMessages)
 {
 	ScopedNoDenormals noDenormals;
+    bool oversampled = false;
+
+    //Csound runs on an upsampled copy of the block, with incoming MIDI timestamps scaled to match
+    if constexpr (std::is_same<Type, float>::value)
+    {
+        if (oversampler != nullptr && csdCompiledWithoutError())
+        {
+            dsp::AudioBlock<float> block (buffer);
+            auto upsampledBlock = oversampler->processSamplesUp (block);
+
+            float* channels[64];
+            const int numChannels = jmin ((int) upsampledBlock.getNumChannels(), 64);
+
+            for (int channel = 0; channel < numChannels; channel++)
+                channels[channel] = upsampledBlock.getChannelPointer ((size_t) channel);
+
+            AudioBuffer<float> upsampledBuffer (channels, numChannels, (int) upsampledBlock.getNumSamples());
+            processCsoundSamples (upsampledBuffer, midiMessages, oversamplingFactor);
+            oversampler->processSamplesDown (block);
+            oversampled = true;
+        }
+    }
+
+    //double precision processing is turned off, so there's no oversampler for it
+    if (!oversampled)
+        processCsoundSamples (buffer, midiMessages, 1);
+
+    recorder.processBlock (buffer);
+#if JucePlugin_ProducesMidiOutput
+
+	if (!midiOutputBuffer.isEmpty())
+	{
+		midiMessages.clear();
+		midiMessages.swapWith(midiOutputBuffer);
+	}
+	else
+		midiMessages.clear();
+
+#endif
+}
+
+template< typename Type >
+void CsoundPluginProcessor::processCsoundSamples(AudioBuffer< Type >& buffer, MidiBuffer& midiMessages, int midiTimeScale)
+{
     auto mainOutput = getBusBuffer(buffer, false, 0);
 #if !JucePlugin_IsSynth
     auto mainInput = getBusBuffer(buffer, true, 0);
@@ -1307,10 +1539,13 @@ void CsoundPluginProcessor::processSamples(AudioBuffer< Type >& buffer, MidiBuff
 	if (getTotalNumInputChannels() == 0)
 		buffer.clear();
 
-	keyboardState.processNextMidiBuffer(midiMessages, 0, numSamples, true);
+	keyboardState.processNextMidiBuffer(midiMessages, 0, numSamples / midiTimeScale, true);
+
+    if (csdCompiledWithoutError() && numMatrixEventSequencers.load() > 0)
+        processMatrixEventSequencers(numSamples);
     
     if(isLMMS)
-	    midiBuffer.addEvents(midiMessages, 0, numSamples, 0);
+	    midiBuffer.addEvents(midiMessages, 0, numSamples / midiTimeScale, 0);
     
     int samplePos = 0;
     MidiMessage message;
@@ -1339,7 +1574,7 @@ void CsoundPluginProcessor::processSamples(AudioBuffer< Type >& buffer, MidiBuff
                 while (iter.getNextEvent(message, samplePos))
                 {
                     //if current sample position matches time code for MIDI event, add it to buffer that gets sent to Csound as incoming MIDI...
-                    if (samplePos == i)
+                    if (samplePos * midiTimeScale == i)
                         midiBuffer.addEvent(message, samplePos);
                 }
 
@@ -1413,24 +1648,24 @@ void CsoundPluginProcessor::processSamples(AudioBuffer< Type >& buffer, MidiBuff
             buffer.clear (channel, 0, buffer.getNumSamples());
         }
     }
+}
 
-    AudioBuffer<float> writerBuffer;
-    writerBuffer.makeCopyOf(buffer);
-    if (activeWriter.load() != nullptr)
-    {
-         activeWriter.load()->write (writerBuffer.getArrayOfWritePointers(), writerBuffer.getNumSamples());
-    }
-#if JucePlugin_ProducesMidiOutput
+void CsoundPluginProcessor::processMatrixEventSequencers(int numSamples)
+{
+    const SpinLock::ScopedTryLockType sl(matrixEventSequencerLock);
 
-	if (!midiOutputBuffer.isEmpty())
-	{
-		midiMessages.clear();
-		midiMessages.swapWith(midiOutputBuffer);
-	}
-	else
-		midiMessages.clear();
+    if (!sl.isLocked())
+        return;
 
-#endif
+    AudioPlayHead::CurrentPositionInfo position;
+    AudioPlayHead* playHead = getPlayHead();
+    const bool hasPosition = playHead != nullptr && playHead->getCurrentPosition(position);
+
+    //steps are timed from where the block's first k-cycle starts, that's when the events reach Csound
+    const int firstKCycle = csndIndex >= csdKsmps ? 0 : csdKsmps - csndIndex;
+
+    for (auto* matrixEventSequencer : matrixEventSequencers)
+        matrixEventSequencer->process(hasPosition ? &position : nullptr, numSamples, csound->GetSr(), firstKCycle, scoreEvents);
 }
 
 //==============================================================================
@@ -1476,33 +1711,33 @@ void CsoundPluginProcessor::breakpointCallback (CSOUND* csound, debug_bkpt_info_
 }
 
 //==============================================================================
-CsoundPluginProcessor::SignalDisplay* CsoundPluginProcessor::getSignalArray (String variableName, String displayType) const
+CsoundPluginProcessor::SignalDisplay* CsoundPluginProcessor::getSignalArray (const String& variableName, const String& displayType) const
 {
+    //Csound adds displays from its performance thread, so the array's lock is held while it's read
+    const ScopedLock sl (signalArrays.getLock());
+    const String key = variableName + ":" + displayType;
+
+    if (auto* signalArray = signalArraysByName[key])
+        return signalArray;
+
+    //only displays that have been found are remembered, one that doesn't exist yet may be made later
     for (auto signalArray : signalArrays)
     {
-        const String test = signalArray->caption;
         if (signalArray->caption.isNotEmpty() && signalArray->caption.contains (variableName))
         {
-            const String varName = signalArray->variableName;
-            if (displayType.isEmpty()){
-                return signalArray;
-            }
-
-            else if (displayType == "waveform" && !signalArray->caption.contains ("fft")){
-                return signalArray;
-            }
-
-            else if (displayType == "lissajous" && !signalArray->caption.contains ("fft")){
-                return signalArray;
-            }
+            const bool isFFT = signalArray->caption.contains ("fft");
 
-            else if (displayType != "waveform" && signalArray->caption.contains ("fft")){
+            if (displayType.isEmpty()
+                || ((displayType == "waveform" || displayType == "lissajous") && !isFFT)
+                || (displayType != "waveform" && isFFT))
+            {
+                signalArraysByName.set (key, signalArray);
                 return signalArray;
             }
         }
     }
 
-    return new SignalDisplay ("", -1, 0, 0, 0, 0);
+    return nullptr;
 }
 //==============================================================================
 bool CsoundPluginProcessor::hasEditor() const
@@ -1612,18 +1847,24 @@ void CsoundPluginProcessor::makeGraphCallback (CSOUND* csound, WINDAT* windat, c
 {
     ignoreUnused(name);
     auto* ud = static_cast<CsoundPluginProcessor*>(csoundGetHostData (csound));
-    auto* display = new SignalDisplay (String (windat->caption), (int)windat->windid, (float)windat->oabsmax, (int)windat->min, (int)windat->max, (int)windat->npts);
 
-    bool addDisplay = true;
+    //the windid is handed back to us in drawGraphCallback, so use it as an index into signalArrays
+    //rather than searching through the displays by caption for every frame. It's stored as index + 1,
+    //because Csound takes a windid of 0 to mean the window hasn't been made yet and would call us again
+    windat->windid = (uintptr_t) -1;
 
-    for (auto signalArray : ud->signalArrays)
+    for (int i = 0; i < ud->signalArrays.size(); i++)
     {
-        if (signalArray->caption == windat->caption)
-            addDisplay  = false;
+        if (ud->signalArrays[i]->caption == windat->caption)
+        {
+            windat->windid = (uintptr_t) i + 1;
+            return;
+        }
     }
 
-    if (addDisplay && !String(windat->caption).contains("ftable"))
+    if (!String(windat->caption).contains("ftable"))
     {
+        auto* display = new SignalDisplay (String (windat->caption), ud->signalArrays.size(), (float)windat->oabsmax, (int)windat->min, (int)windat->max, (int)windat->npts);
         const String captionName = String(windat->caption).substring(String(windat->caption).indexOf("signal ")+7);
         const int posColon = String(captionName).indexOf(":");
         const int posComma = String(captionName).indexOf(",");
@@ -1634,23 +1875,20 @@ void CsoundPluginProcessor::makeGraphCallback (CSOUND* csound, WINDAT* windat, c
             variableName = captionName.substring(0, posColon);
 
         display->variableName = variableName;
+        windat->windid = (uintptr_t) ud->signalArrays.size() + 1;
         ud->signalArrays.add (display);
-        ud->updateSignalDisplay.set(variableName, false);
     }
 }
 
 void CsoundPluginProcessor::drawGraphCallback (CSOUND* csound, WINDAT* windat)
 {
-    ignoreUnused(csound);
     auto* ud = static_cast<CsoundPluginProcessor*> (csoundGetHostData (csound));
-    Array<float, CriticalSection> tablePoints;
-    //only take all samples if dealing with fft, waveforms and lissajous curves can be drawn with less samples
-    tablePoints = Array<float, CriticalSection> (&windat->fdata[0], windat->npts);
-    ud->getSignalArray (windat->caption)->setPoints (tablePoints);
-    const String test = ud->getSignalArray (windat->caption)->variableName;
-    if(ud->getSignalArray (windat->caption)->variableName.isNotEmpty())
-        ud->updateSignalDisplay.set(ud->getSignalArray (windat->caption)->variableName, true);
-    
+
+    //displays are only ever added from this thread, so there's no need to take the array's lock here
+    const uintptr_t index = windat->windid - 1;
+
+    if (index < (uintptr_t) ud->signalArrays.size())
+        ud->signalArrays.getRawDataPointer()[index]->publish (windat->fdata, (int) windat->npts);
 }
 
 void CsoundPluginProcessor::killGraphCallback (CSOUND* csound, WINDAT* windat)
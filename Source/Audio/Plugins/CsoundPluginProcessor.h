@@ -32,9 +32,14 @@
 #include "../../Opcodes/CabbageWebUIOpcodes.h"
 #endif
 #include "../../Opcodes/CabbageIdentifierOpcodes.h"
-//#include "../../Opcodes/CabbageFileReaderOpcodes.h"
+#include "../../Opcodes/CabbageFileReaderOpcodes.h"
 #include "../../Utilities/CabbageUtilities.h"
 #include "CabbageCsoundBreakpointData.h"
+#include "CsoundMessageLog.h"
+#include "CabbageAudioRecorder.h"
+#include "CsoundThreadBudget.h"
+#include "CsoundScoreEventQueue.h"
+#include "CabbageMatrixEventSequencer.h"
 #if CabbagePro
 #include "../../Utilities/encrypt.h"
 #endif
@@ -65,7 +70,7 @@ private:
 };
 
 //==============================================================================
-class CsoundPluginProcessor : public AudioProcessor, public AsyncUpdater
+class CsoundPluginProcessor : public AudioProcessor
 {
 public:
     //==============================================================================
@@ -151,6 +156,9 @@ public:
 	virtual void processBlock(AudioBuffer< double >&, MidiBuffer&) override;
 	template< typename Type >
 	void processSamples(AudioBuffer< Type >&, MidiBuffer&);
+	template< typename Type >
+	void processCsoundSamples(AudioBuffer< Type >&, MidiBuffer&, int midiTimeScale);
+    void processMatrixEventSequencers(int numSamples);
 	//bool supportsDoublePrecisionProcessing() const override { return true; }
 
     virtual void processBlockBypassed (AudioBuffer< float > &buffer, MidiBuffer &midiMessages) override {
@@ -203,13 +211,15 @@ public:
     //graphing functions
     static void makeGraphCallback (CSOUND* csound, WINDAT* windat, const char* name);
     static void drawGraphCallback (CSOUND* csound, WINDAT* windat);
+    static void messageCallback (CSOUND* csound, int attributes, const char* format, va_list args);
     static void killGraphCallback (CSOUND* csound, WINDAT* windat);
     static int exitGraphCallback (CSOUND* csound);
 
     //logger
     void createFileLogger (File csdFile);
 
-    void handleAsyncUpdate() override;
+    //pulls widget data from Csound and sends queued channel data to it, message thread only
+    void updateGuiFromCsound();
     //csound breakpint function
     static void breakpointCallback (CSOUND* csound, debug_bkpt_info_t* bkpt_info, void* udata);
     CabbageCsoundBreakpointData breakPointData;
@@ -234,27 +244,15 @@ public:
 
     AudioPlayHead::CurrentPositionInfo hostInfo = {};
 
-    class MatrixEventSequencer
-    {
-    public:
-        String channel = "";
-        OwnedArray<StringArray> events;
-        int position = 0;
-        void setEventString(int col, int row, String data)
-        {
-            events[col]->set(row, data);
-        }
-
-        explicit MatrixEventSequencer(String csoundChannel):channel(csoundChannel){}
-        ~MatrixEventSequencer(){ events.clear();}
-
-    };
-
-	int numMatrixEventSequencers = 0;
-    void createMatrixEventSequencer(int rows, int cols, String channel);
-    void setMatrixEventSequencerCellData(int row, int col, const String& channel, String data);
+    //returns false if a sequencer of the same size already exists for the channel, in which case it's kept
+    bool createMatrixEventSequencer(int rows, int cols, String channel, bool stepsAreRows = true);
+    void setMatrixEventSequencerCellData(int row, int col, const String& channel, String data, const String& displayText);
+    //message thread only, the audio thread never sees a sequencer being removed
+    CabbageMatrixEventSequencer* getMatrixEventSequencer(const String& channel);
 
     virtual void sendChannelDataToCsound() {}
+    //called on the audio thread before each k-cycle, sample count is ksmps
+    virtual void processAutomation (int) {}
     virtual void getIdentifierDataFromCsound() {}
     void sendHostDataToCsound();
     virtual void getChannelDataFromCsound() {}
@@ -262,6 +260,23 @@ public:
     //=============================================================================
     void addMacros (String& csdText);
     String getCsoundOutput();
+    //bounded copy of the most recent output, for consoles that show the whole log
+    bool getCsoundOutputSnapshot (String& text, int& lastVersionSeen)
+    {
+        return messageLog.getSnapshot (text, lastVersionSeen);
+    }
+    void setCsoundOutputSeverity (CsoundMessageLog::Severity severity)   {   messageLog.setMinimumSeverity (severity);   }
+
+    //queued and handed to Csound at the next k-cycle, without going through the score parser
+    bool sendScoreEvent (char type, const MYFLT* pFields, int numPFields, int sampleOffset = 0)
+    {
+        CsoundScoreEventQueue::Event event;
+        event.type = type;
+        event.pFields = pFields;
+        event.numPFields = numPFields;
+        event.sampleOffset = sampleOffset;
+        return scoreEvents.add (event);
+    }
 
     void compileCsdFile (File csoundFile)
     {
@@ -285,15 +300,34 @@ public:
         return csound.get();
     }
 
+    //changes every time a new Csound instance is created, so pointers into a previous one can be spotted
+    int getCsoundInstanceNumber() const
+    {
+        return csoundInstanceNumber;
+    }
+
     CSOUND* getCsoundStruct()
     {
         return csound->GetCsound();
     }
 
-    void setGUIRefreshRate (int rate)
+    void setGUIRefreshRate (int rate, bool rateIsInHz = false)
     {
         guiRefreshRate = rate;
+        guiRefreshRateIsInHz = rateIsInHz;
+        updateGuiRefreshTimer();
     }
+
+    //called by the editor as it opens and closes
+    void setEditorShowing (bool isShowing)
+    {
+        editorShowing = isShowing;
+        updateGuiRefreshTimer();
+    }
+
+    double getGuiRefreshRateInHz() const;
+    //true if something other than the editor, i.e, the host, needs to follow Csound's channels
+    virtual bool hasGuiRefreshListeners()   {   return false;   }
     
     void setNumPreCycles (int num)
     {
@@ -301,10 +335,19 @@ public:
     }
     
     void startRecording(const File& file, int bitDepth = 32);
+    bool startRecording (const CabbageAudioRecorder::Options& options);
+    //starts capturing so that options.preRollSeconds of audio is available when startRecording() is called
+    bool armRecording (const CabbageAudioRecorder::Options& options);
+    void startRecording();
     void stopRecording();
     bool isRecording() const
     {
-        return activeWriter.load() != nullptr;
+        return recorder.isRecording();
+    }
+
+    CabbageAudioRecorder::Statistics getRecordingStatistics() const
+    {
+        return recorder.getStatistics();
     }
     
     
@@ -313,6 +356,9 @@ public:
     bool hostIsCubase = false;
 
     //==================================================================================
+    // Points for a single display/dispfft graph. Csound publishes each frame into a
+    // preallocated triple buffer from its performance thread, without locking or
+    // allocating, and the editor picks up the most recent frame on the message thread.
     class SignalDisplay
     {
     public:
@@ -325,45 +371,67 @@ public:
             windid (_id),
             min1 (_min),
             max1 (_max),
-            size (_size),
+            size (jmax (0, _size)),
             caption (_caption)
-        {}
-
-        ~SignalDisplay()
         {
-            points.clear();
+            for (auto& buffer : buffers)
+                buffer.calloc ((size_t) jmax (1, size));
         }
 
-        Array<float, CriticalSection> getPoints()
+        //Csound performance thread
+        void publish (const MYFLT* data, int numPoints)
         {
-            return points;
+            const int numToCopy = jlimit (0, size, numPoints);
+            float* dest = buffers[writeIndex].get();
+
+            for (int i = 0; i < numToCopy; i++)
+                dest[i] = (float) data[i];
+
+            numPointsInBuffer[writeIndex] = numToCopy;
+            writeIndex = latestIndex.exchange (writeIndex | newDataFlag) & indexMask;
         }
 
-        void setPoints (Array <float, CriticalSection > tablePoints)
+        //message thread, several widgets can show the same signal so each one keeps track of the last frame it drew
+        bool getPoints (Array<float, CriticalSection>& points, int& lastFrameSeen)
         {
-            points.swapWith (tablePoints);
+            if ((latestIndex.load() & newDataFlag) != 0)
+            {
+                readIndex = latestIndex.exchange (readIndex) & indexMask;
+                ++frameCount;
+            }
+
+            if (frameCount == lastFrameSeen)
+                return false;
+
+            lastFrameSeen = frameCount;
+            points.clearQuick();
+            points.addArray (buffers[readIndex].get(), numPointsInBuffer[readIndex]);
+            return true;
         }
-        
 
     private:
-        Array <float, CriticalSection > points;
-    };
+        static constexpr int indexMask = 3;
+        static constexpr int newDataFlag = 4;
 
-    bool shouldUpdateSignalDisplay(String signalDisplayName)
-    {
-        bool returnVal = bool(updateSignalDisplay.getWithDefault(signalDisplayName, false));
-        updateSignalDisplay.set(signalDisplayName, false);
-        return returnVal;
-    }
+        HeapBlock<float> buffers[3];
+        int numPointsInBuffer[3] = { 0, 0, 0 };
+        int writeIndex = 0, readIndex = 1;
+        std::atomic<int> latestIndex { 2 };
+        int frameCount = 0;
+
+        JUCE_DECLARE_NON_COPYABLE (SignalDisplay)
+    };
 
-    TimeSliceThread backgroundThread { "Audio Recorder Thread" }; // the thread that will write our audio data to disk
-    std::unique_ptr<AudioFormatWriter::ThreadedWriter> threadedWriter; // the FIFO used to buffer the incoming data
-    std::atomic<AudioFormatWriter::ThreadedWriter*> activeWriter { nullptr };
-    std::unique_ptr<AudioData::Converter> converter;
-    CriticalSection writerLock;
-    OwnedArray<MatrixEventSequencer> matrixEventSequencers;
+    CabbageAudioRecorder recorder;
+    OwnedArray<CabbageMatrixEventSequencer> matrixEventSequencers;
+    HashMap<String, CabbageMatrixEventSequencer*> matrixEventSequencersByChannel;
+    //held while the list changes, the audio thread skips sequencing rather than wait for it
+    SpinLock matrixEventSequencerLock;
+    std::atomic<int> numMatrixEventSequencers { 0 };
     OwnedArray <SignalDisplay, CriticalSection> signalArrays;   //holds values from FFT function table created using dispfft
-    CsoundPluginProcessor::SignalDisplay* getSignalArray (String variableName, String displayType = "") const;
+    //displays found by getSignalArray(), keyed by variable name and display type. Displays are never removed, so entries stay valid
+    mutable HashMap<String, SignalDisplay*> signalArraysByName;
+    CsoundPluginProcessor::SignalDisplay* getSignalArray (const String& variableName, const String& displayType = "") const;
 
     String getInternalState()
     {
@@ -380,14 +448,49 @@ public:
     void setPreferredLatency(int latency)
     {
         preferredLatency = latency;
-        setLatencySamples(preferredLatency);
+        setLatencySamples(jmax(0, preferredLatency) + getOversamplingLatency());
     }
     
     int pollingChannels()
     {
         return polling;
     }
+
+    //overrides the form's threads() identifier from the next compile on, -1 goes back to using it
+    void setNumberOfCsoundThreads (int numThreads)
+    {
+        csoundThreadsOverride = numThreads;
+    }
+
+    //the number of threads Csound was actually compiled with
+    int getNumberOfCsoundThreads() const
+    {
+        return numCsoundThreads;
+    }
+
+    //2, 4 or 8 runs Csound at that multiple of the host rate, 1 turns oversampling off and 0 goes back to the form's oversampling()
+    void setOversamplingFactor (int factor);
+
+    int getOversamplingFactor() const
+    {
+        return oversamplingFactor;
+    }
+
+    //largest ksmps in the range that divides the host block size evenly, so k-cycles start with each block
+    static int chooseKsmpsForBlockSize (int blockSize, int minKsmps, int maxKsmps);
     
+    //true when prepareToPlay() with these settings has to recompile Csound, a new block size on its own never does
+    bool needsRecompile (double sampleRate, int samplesPerBlock);
+
+    //current values of the named control channels, held in memory so a recompile can put them back without going through the saved state
+    struct ChannelSnapshot
+    {
+        Array<std::pair<String, MYFLT>> controlChannels;
+    };
+
+    ChannelSnapshot snapshotChannels (const StringArray& channelNames);
+    void restoreChannels (const ChannelSnapshot& snapshot);
+
     bool wasRecompiled() { return recompiledOnPrepareToPlay;   }
     void resetRecompiled() { recompiledOnPrepareToPlay = false; }
     ProcessBlockTimeListener processBlockListener;
@@ -396,8 +499,38 @@ private:
     bool recompiledOnPrepareToPlay = false;
     int polling = 1;
     MidiBuffer midiOutputBuffer;
-    int guiCycles = 0;
     int guiRefreshRate = 128;
+    bool guiRefreshRateIsInHz = false;
+    bool editorShowing = false;
+    std::atomic<uint32> ksmpsPerformed { 0 };
+    void updateGuiRefreshTimer();
+
+    //==================================================================================
+    // Updates the GUI from Csound at a fixed wall-clock rate while an editor or listener is
+    // attached. The audio thread only bumps ksmpsPerformed, so nothing is ever posted from
+    // it, and ticks where Csound hasn't performed since the last one are skipped.
+    class GuiRefreshScheduler : public Timer
+    {
+    public:
+        explicit GuiRefreshScheduler (CsoundPluginProcessor& processor) : owner (processor) {}
+
+        void timerCallback() override
+        {
+            const uint32 cycles = owner.ksmpsPerformed.load (std::memory_order_relaxed);
+
+            if (cycles != lastCycles)
+            {
+                lastCycles = cycles;
+                owner.updateGuiFromCsound();
+            }
+        }
+
+    private:
+        CsoundPluginProcessor& owner;
+        uint32 lastCycles = 0;
+    };
+
+    GuiRefreshScheduler guiRefreshScheduler { *this };
     MidiBuffer midiBuffer = {};
     String csoundOutput = {};
     std::unique_ptr<CSOUND_PARAMS> csoundParams;
@@ -405,7 +538,6 @@ private:
     int numCsoundOutputChannels = 0;
     int numCsoundInputChannels = 0;
     int pos = 0;
-    NamedValueSet updateSignalDisplay;
     MYFLT cs_scale = 0.0;
     bool testLogicForMono = true;
     MYFLT *CSspin = nullptr;
@@ -414,11 +546,25 @@ private:
     int csndIndex = 0;
     int csdKsmps = 0;
     File csdFile = {}, csdFilePath = {};
+    //declared before csound so it's still around for anything Csound prints as it's destroyed
+    CsoundMessageLog messageLog;
+    CsoundScoreEventQueue scoreEvents;
     std::unique_ptr<Csound> csound;
-    std::unique_ptr<FileLogger> fileLogger;
+    int csoundInstanceNumber = 0;
 //    int busIndex = 0;
     bool disableLogging = false;
 	int preferredLatency = 32;
+    int requestedCsoundThreads = 1, csoundThreadsOverride = -1, numCsoundThreads = 1;
+    bool singleThreadedFallback = false;
+    int ksmpsRangeMin = 0, ksmpsRangeMax = 0, hostBlockSize = 0;
+    int requestedOversampling = 1, oversamplingOverride = 0, oversamplingFactor = 1;
+    std::unique_ptr<dsp::Oversampling<float>> oversampler;
+    int oversamplerNumChannels = 0;
+    int getRequestedOversamplingFactor() const;
+    int getOversamplingLatency() const;
+    SharedResourcePointer<CsoundThreadBudget> threadBudget;
+    //keeps directory listings for string comboboxes around between compiles and editors
+    SharedResourcePointer<CabbageDirectoryIndex> directoryIndex;
     String internalStateData = {};
 
 
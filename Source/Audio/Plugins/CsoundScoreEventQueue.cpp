@@ -0,0 +1,124 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CsoundScoreEventQueue.h"
+
+//==============================================================================
+CsoundScoreEventQueue::CsoundScoreEventQueue()
+{
+    ringBuffer.allocate (ringBufferSize, true);
+    pFieldBuffer.allocate (maxPFields, true);
+}
+
+bool CsoundScoreEventQueue::add (const Event* events, int numEvents)
+{
+    int batchSize = 0;
+
+    for (int i = 0; i < numEvents; i++)
+    {
+        if (events[i].numPFields < 0 || events[i].numPFields > maxPFields)
+        {
+            numDroppedEvents.fetch_add (numEvents);
+            return false;
+        }
+
+        batchSize += getRecordSize (events[i]);
+    }
+
+    //the lock only keeps concurrent writers apart, the performance thread never takes it
+    const SpinLock::ScopedLockType sl (writeLock);
+
+    if (fifo.getFreeSpace() < batchSize)
+    {
+        numDroppedEvents.fetch_add (numEvents);
+        return false;
+    }
+
+    //the whole batch becomes visible to the reader at once
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (batchSize, start1, size1, start2, size2);
+    int writePosition = start1;
+
+    for (int i = 0; i < numEvents; i++)
+    {
+        const Event& event = events[i];
+        const EventHeader header { event.type, event.absolute, event.numPFields, event.sampleOffset, event.absoluteTime };
+        write (writePosition, &header, sizeof (EventHeader));
+        write (writePosition, event.pFields, (int) sizeof (MYFLT) * event.numPFields);
+    }
+
+    fifo.finishedWrite (size1 + size2);
+    return true;
+}
+
+void CsoundScoreEventQueue::clear()
+{
+    const SpinLock::ScopedLockType sl (writeLock);
+    fifo.finishedRead (fifo.getNumReady());
+}
+
+void CsoundScoreEventQueue::sendQueuedEvents (Csound& csound)
+{
+    if (fifo.getNumReady() == 0)
+        return;
+
+    const double sr = csound.GetSr();
+
+    //batches are committed whole, so once a header is ready its p-fields are too
+    while (fifo.getNumReady() >= (int) sizeof (EventHeader))
+    {
+        EventHeader header;
+        read (&header, sizeof (EventHeader));
+        read (pFieldBuffer, (int) sizeof (MYFLT) * header.numPFields);
+
+        if (header.sampleOffset != 0 && header.numPFields > 1 && sr > 0)
+            pFieldBuffer[1] += header.sampleOffset / sr;
+
+        if (header.absolute)
+            csound.ScoreEventAbsolute (header.type, pFieldBuffer, header.numPFields, header.absoluteTime);
+        else
+            csound.ScoreEvent (header.type, pFieldBuffer, header.numPFields);
+    }
+}
+
+void CsoundScoreEventQueue::write (int& position, const void* data, int numBytes)
+{
+    if (numBytes == 0)
+        return;
+
+    const int size1 = jmin (numBytes, ringBufferSize - position);
+    memcpy (ringBuffer + position, data, (size_t) size1);
+    if (numBytes > size1)
+        memcpy (ringBuffer.get(), static_cast<const char*> (data) + size1, (size_t) (numBytes - size1));
+
+    position = (position + numBytes) % ringBufferSize;
+}
+
+void CsoundScoreEventQueue::read (void* dest, int numBytes)
+{
+    if (numBytes == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (numBytes, start1, size1, start2, size2);
+    memcpy (dest, ringBuffer + start1, (size_t) size1);
+    if (size2 > 0)
+        memcpy (static_cast<char*> (dest) + size1, ringBuffer + start2, (size_t) size2);
+    fifo.finishedRead (size1 + size2);
+}
@@ -0,0 +1,90 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CSOUNDSCOREEVENTQUEUE_H_INCLUDED
+#define CSOUNDSCOREEVENTQUEUE_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <csound.hpp>
+
+//==============================================================================
+// Score events headed for Csound, kept as p-field arrays rather than text.
+// Events are copied into a preallocated ring buffer and handed to Csound's
+// ScoreEvent()/ScoreEventAbsolute() at the start of the next k-cycle, on
+// the performance thread. Csound never has to parse them and the GUI never
+// waits on the performance thread. A batch is queued either whole or not
+// at all. Events that don't fit are dropped and counted.
+//==============================================================================
+class CsoundScoreEventQueue
+{
+public:
+    static constexpr int ringBufferSize = 64 * 1024;
+    static constexpr int maxPFields = 1024;
+
+    struct Event
+    {
+        char type = 'i';                    //'i', 'f', 'q', 'a' or 'e', as in a score
+        const MYFLT* pFields = nullptr;     //p1 onwards
+        int numPFields = 0;
+        int sampleOffset = 0;               //added to p2, in samples from the next k-cycle
+        bool absolute = false;              //use absoluteTime rather than timing from now
+        double absoluteTime = 0;            //seconds, as ScoreEventAbsolute's time_ofs
+    };
+
+    CsoundScoreEventQueue();
+
+    //any thread
+    bool add (const Event& event)       {   return add (&event, 1);    }
+    bool add (const Event* events, int numEvents);
+    int getNumDroppedEvents() const     {   return numDroppedEvents.load();    }
+
+    //performance thread, before each k-cycle
+    void sendQueuedEvents (Csound& csound);
+
+    //drops anything still queued, only while Csound isn't performing, e.g. when it's recompiled
+    void clear();
+
+private:
+    struct EventHeader
+    {
+        char type;
+        bool absolute;
+        int numPFields;
+        int sampleOffset;
+        double absoluteTime;
+    };
+
+    static int getRecordSize (const Event& event)
+    {
+        return (int) (sizeof (EventHeader) + sizeof (MYFLT) * (size_t) event.numPFields);
+    }
+
+    void write (int& position, const void* data, int numBytes);
+    void read (void* dest, int numBytes);
+
+    HeapBlock<char> ringBuffer;
+    AbstractFifo fifo { ringBufferSize };
+    SpinLock writeLock;
+    std::atomic<int> numDroppedEvents { 0 };
+    HeapBlock<MYFLT> pFieldBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CsoundScoreEventQueue)
+};
+
+#endif  // CSOUNDSCOREEVENTQUEUE_H_INCLUDED
@@ -0,0 +1,79 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CSOUNDTHREADBUDGET_H_INCLUDED
+#define CSOUNDTHREADBUDGET_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <unordered_map>
+
+//==============================================================================
+// Hands out Csound performance threads (-j) to plugin instances. Every
+// instance in the process draws from one pool. The pool is the machine's
+// physical cores minus one, which is left for the host and the UI. Each
+// instance gets at most an even share of the pool, minus whatever the other
+// instances already hold. Single-threaded instances count too, as each of
+// them keeps a core busy. Instances keep their threads until they recompile,
+// so an instance loaded onto a busy machine simply gets fewer threads. It is
+// held through a SharedResourcePointer.
+//==============================================================================
+class CsoundThreadBudget
+{
+public:
+    //below this Csound's per k-cycle thread sync costs more than it saves
+    static constexpr int minKsmpsForThreads = 16;
+
+    //requestedThreads <= 0 asks for a fair share, the result is always at least 1
+    int acquire (const void* instance, int requestedThreads)
+    {
+        const ScopedLock sl (lock);
+        grants.erase (instance);
+
+        if (requestedThreads == 1)
+        {
+            grants[instance] = 1;
+            return 1;
+        }
+
+        int numHeldByOthers = 0;
+
+        for (const auto& grant : grants)
+            numHeldByOthers += grant.second;
+
+        const int poolSize = jmax (1, SystemStats::getNumPhysicalCpuCores() - 1);
+        const int fairShare = poolSize / ((int) grants.size() + 1);
+        const int available = jmin (fairShare, poolSize - numHeldByOthers);
+        const int granted = jmax (1, requestedThreads > 0 ? jmin (requestedThreads, available) : available);
+
+        grants[instance] = granted;
+        return granted;
+    }
+
+    void release (const void* instance)
+    {
+        const ScopedLock sl (lock);
+        grants.erase (instance);
+    }
+
+private:
+    CriticalSection lock;
+    std::unordered_map<const void*, int> grants;
+};
+
+#endif  // CSOUNDTHREADBUDGET_H_INCLUDED
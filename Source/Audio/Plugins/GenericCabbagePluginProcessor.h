@@ -27,6 +27,8 @@ public:
     OwnedArray<AudioParameterFloat> parameters;
 
     void sendChannelDataToCsound() override;
+    //host automation only reaches Csound through sendChannelDataToCsound()
+    bool hasGuiRefreshListeners() override  {   return true;    }
     void setPluginName (String name) {    pluginName = name;  }
     String getPluginName() { return pluginName;  }
 
@@ -30,7 +30,16 @@ Cabbage::Cabbage()
 //==============================================================================
 void Cabbage::initialise (const String& commandLine)
 {
-    
+    //the IDE starts a second copy of itself to try out csd files before running them
+    auto worker = std::make_unique<CabbageValidationWorker>();
+
+    if (worker->initialiseFromCommandLine (commandLine, CabbageValidationWorker::commandLineUID))
+    {
+        isRunningCommandLine = true;
+        validationWorker = std::move (worker);
+        return;
+    }
+
     documentWindow.reset (new CabbageDocumentWindow (getApplicationName(), getCommandLineParameters()));
 
     if (commandLine.isEmpty())
@@ -21,6 +21,7 @@
 #define CABBAGEAPPLICATION_H_INCLUDED  
 
 #include "CabbageCommonHeaders.h"
+#include "Application/CabbageValidationWorker.h"
 
 
 class CabbageProjectWindow;
@@ -62,6 +63,7 @@ public:
 
 private:
     std::unique_ptr<CabbageDocumentWindow> documentWindow;
+    std::unique_ptr<CabbageValidationWorker> validationWorker;
 };
 
 
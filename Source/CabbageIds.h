@@ -119,6 +119,7 @@ namespace CommandIDs
         showToolsMenu           = 0x6120015,
         showViewMenu            = 0x6120016,
         showHelpMenu            = 0x6120017,
+        showRepaintCost         = 0x6120018,
         lastCommandIDEntry
     };
 }
@@ -451,7 +452,14 @@ public:
         add ("cellData");
         add ("isparent");
         add ("glShader");
+        add ("logLevel");
         add ("latency");
+        add ("threads");
+        add ("ksmpsRange");
+        add ("oversampling");
+        add ("stepSize");
+        add ("swing");
+        add ("trackLengths");
         add ("color:0");
         add ("color:1");
         add ("caption");
@@ -650,6 +658,7 @@ namespace CabbageIdentifierIds
     static const Identifier fontsize = "fontSize";
     static const Identifier gradient = "gradient";
     static const Identifier guirefresh = "guiRefresh";
+    static const Identifier guirefreshunit = "guiRefreshUnit";
     static const Identifier precycles = "preCycles";
     static const Identifier guimode = "guiMode";
     static const Identifier glshader = "glShader";
@@ -687,8 +696,11 @@ namespace CabbageIdentifierIds
     static const Identifier left = "left";
     static const Identifier linenumber = "lineNumber";
     static const Identifier latency = "latency";
+    static const Identifier ksmpsmin = "ksmpsMin";
+    static const Identifier ksmpsmax = "ksmpsMax";
     static const Identifier linethickness = "lineThickness";
     static const Identifier logger = "logger";
+    static const Identifier loglevel = "logLevel";
     static const Identifier mountPoint = "mountPoint";
     static const Identifier macrostrings = "macrostrings";
     static const Identifier markercolour = "markerColour";
@@ -725,6 +737,7 @@ namespace CabbageIdentifierIds
     static const Identifier openGL = "openGL";
     static const Identifier onfontcolour = "onFontColour";
     static const Identifier opcodedir = "opcodeDir";
+    static const Identifier oversampling = "oversampling";
     static const Identifier opcode6dir64 = "opcode6Dir64";
     static const Identifier ignorelastdir = "ignoreLastOpenedDir";
     static const Identifier orientation = "orientation";
@@ -791,8 +804,10 @@ namespace CabbageIdentifierIds
     static const Identifier stack = "stack";
     static const Identifier movebehind = "moveBehind";
     static const Identifier startpoint = "startPoint";
+    static const Identifier stepsize = "stepSize";
     static const Identifier startpos = "startPos";
     static const Identifier style = "style";
+    static const Identifier swing = "swing";
     static const Identifier surrogatelinenumber = "surrogatelinenumber";
     static const Identifier tabbed = "tabbed";
     static const Identifier tablebackgroundcolour = "tableBackgroundColour";
@@ -809,9 +824,11 @@ namespace CabbageIdentifierIds
     static const Identifier titlebarcolour = "titleBarColour";
     static const Identifier titlebargradient = "titleBarGradient";
     static const Identifier titlebarheight = "titleBarHeight";
+    static const Identifier threads = "threads";
     static const Identifier tofront = "toFront";
     static const Identifier top = "top";
     static const Identifier trackercolour = "trackerColour";
+    static const Identifier tracklengths = "trackLengths";
     static const Identifier trackerstart = "trackerStart";
     static const Identifier trackerend = "trackerEnd";
     static const Identifier trackercentre = "trackerCentre";
@@ -380,7 +380,7 @@ void CabbageCodeEditorComponent::replaceText (String text, String replaceWith)
 // start to make the editor less responsive...
 void CabbageCodeEditorComponent::codeDocumentTextInserted (const String& text, int startIndex)
 {
-    const Range<int> range = CabbageUtilities::getCabbageSectionRange(getDocument().getAllContent());
+    const Range<int> range = getCabbageSectionRange();
 
     
     const String lineFromCsd = getDocument().getLine (getDocument().findWordBreakBefore (getCaretPos()).getLineNumber());
@@ -1178,8 +1178,7 @@ void CabbageCodeEditorComponent::undoText()
 //==============================================================================
 const String CabbageCodeEditorComponent::getLineText (int lineNumber)
 {
-    const StringArray csdArray = getAllTextAsStringArray();
-    return csdArray[lineNumber];
+    return getDocument().getLine (lineNumber).trimCharactersAtEnd ("\r\n");
 }
 
 //==============================================================================
@@ -1188,45 +1187,57 @@ void CabbageCodeEditorComponent::insertCode (int lineNumber, String codeToInsert
     // This method is called when users move widgets around in GUI edit mode.
     // As the user is updating the plugin GUI, we don't need to, hence the
     // allowUpdateOfPluginGUI is set to false
+    applyLineEdits ({ { lineNumber, codeToInsert, replaceExistingLine } }, shouldHighlight ? lineNumber : -1);
+}
+
+//==============================================================================
+void CabbageCodeEditorComponent::applyLineEdits (const Array<LineEdit>& edits, int lineToHighlight)
+{
     allowUpdateOfPluginGUI = false;
+    CodeDocument& document = getDocument();
+    bool hasChanged = false;
 
-    StringArray csdLines;
-    csdLines.addLines (getDocument().getAllContent());
+    //only the affected lines are touched, the rest of the document, and its undo history, is left alone
+    for (const auto& edit : edits)
+    {
+        const String currentLine = getLineText (edit.lineNumber);
 
-    if (replaceExistingLine)
-        csdLines.set (lineNumber, codeToInsert);
-    else
-        csdLines.insert (lineNumber, codeToInsert);
+        if (edit.replaceExistingLine && currentLine == edit.text)
+            continue;
 
-    getDocument().replaceAllContent (csdLines.joinIntoString ("\n"));
+        if (! hasChanged)
+            document.newTransaction();
 
-    if (shouldHighlight)
-        highlightLine (lineNumber);
-}
+        hasChanged = true;
+        const CodeDocument::Position lineStart (document, edit.lineNumber, 0);
 
-//==============================================================================
-void CabbageCodeEditorComponent::updateBoundsText (int lineNumber, String codeToInsert, bool shouldHighlight)
-{
-    StringArray csdLines;
-    csdLines.addLines (getDocument().getAllContent());
-    const int currentIndexOfBounds = csdLines[lineNumber].indexOf("bounds");
-    const int newIndexOfBounds = csdLines[lineNumber].indexOf("bounds");
-    const String currentLine = csdLines[lineNumber];
-    const String currentBounds = currentLine.substring(currentIndexOfBounds, currentLine.indexOf(currentIndexOfBounds, ")")+1);
-    const String newBounds = codeToInsert.substring(newIndexOfBounds, codeToInsert.indexOf(newIndexOfBounds, ")")+1);
-    
-    if(currentIndexOfBounds == -1)
-        csdLines.insert (lineNumber, codeToInsert);
-    else
-    {
-        csdLines.set (lineNumber, currentLine.replace(currentBounds, newBounds));
+        if (edit.replaceExistingLine)
+            document.replaceSection (lineStart.getPosition(), lineStart.getPosition() + currentLine.length(), edit.text);
+        else
+            document.insertText (lineStart, edit.text + document.getNewLineCharacters());
     }
 
+    if (hasChanged)
+        document.newTransaction();
 
-    getDocument().replaceAllContent (csdLines.joinIntoString ("\n"));
+    if (lineToHighlight >= 0)
+        highlightLine (lineToHighlight);
+}
 
-    if (shouldHighlight)
-        highlightLine (lineNumber);
+Range<int> CabbageCodeEditorComponent::getCabbageSectionRange()
+{
+    //edits to the tag lines themselves can leave the positions pointing somewhere else
+    if (cabbageSectionStart.getOwner() == &getDocument()
+        && getLineText (cabbageSectionStart.getLineNumber()) == "<Cabbage>"
+        && getLineText (cabbageSectionEnd.getLineNumber()).contains ("</Cabbage>"))
+        return { cabbageSectionStart.getLineNumber(), cabbageSectionEnd.getLineNumber() };
+
+    const Range<int> range = CabbageUtilities::getCabbageSectionRange (getDocument().getAllContent());
+    cabbageSectionStart = CodeDocument::Position (getDocument(), range.getStart(), 0);
+    cabbageSectionEnd = CodeDocument::Position (getDocument(), range.getEnd(), 0);
+    cabbageSectionStart.setPositionMaintained (true);
+    cabbageSectionEnd.setPositionMaintained (true);
+    return range;
 }
 
 
@@ -163,9 +163,19 @@ public:
     void handleEscapeKey() override;
     void mouseWheelMove (const MouseEvent& e, const MouseWheelDetails& mouse) override;
     void insertCode (int lineNumber, String codeToInsert, bool replaceExistingLine, bool highlightLine);
+
+    //changes made in the GUI editor, applied line by line as a single undoable edit
+    struct LineEdit
+    {
+        int lineNumber;
+        String text;
+        bool replaceExistingLine;
+    };
+
+    void applyLineEdits (const Array<LineEdit>& edits, int lineToHighlight);
+    Range<int> getCabbageSectionRange();
     void insertNewLine (String text);
     void insertTextAtCaret (const String& textToInsert) override;
-    void updateBoundsText (int lineNumber, String codeToInsert, bool shouldHighlight);
     void insertMultiLineTextAtCaret (String text);
     void insertText (String text);
     void highlightLines (int firstLine, int lastLine);
@@ -219,6 +229,10 @@ public:
     String lastAction;
     bool allowUpdateOfPluginGUI = false;
 
+private:
+    //the <Cabbage> and </Cabbage> lines, kept up to date by the document as it's edited
+    CodeDocument::Position cabbageSectionStart, cabbageSectionEnd;
+
 
 };
 
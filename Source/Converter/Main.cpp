@@ -3,6 +3,7 @@
 #include "../Utilities/CabbageExportPlugin.h"
 #include "../CabbageCommonHeaders.h"
 #include "../Utilities/CabbageUtilities.h"
+#include <map>
 
 
 const String getPluginInfo (File csdFile, String info)
@@ -28,6 +29,175 @@ const String getPluginInfo (File csdFile, String info)
     return String();
 }
 
+//==============================================================================
+// Batch exports. The manifest is a JSON file listing csds and the formats to
+// export each of them as, with paths relative to the manifest:
+//
+//  {
+//      "destination": "build/plugins",
+//      "plugins": [
+//          { "csd": "synths/Pad.csd", "types": [ "VST3i", "AUi" ] },
+//          { "csd": "fx/Delay.csd", "types": [ "VST3" ], "destination": "build/fx" }
+//      ]
+//  }
+//
+// Each csd is exported by its own job, and jobs run in parallel. The formats
+// for one csd and destination are exported one after the other, as they write
+// the same .csd on some platforms. Formats that would write the same plugin
+// file, VST3 and VST3i for instance, need different destinations, and a
+// manifest that asks for both in one destination is rejected. The converter
+// exits with 1 if any csd was skipped or any export failed.
+//==============================================================================
+struct ExportJob
+{
+    File csdFile;
+    StringArray types;
+    String pluginId;
+    File destination;
+};
+
+static bool readBatchManifest (const File& manifestFile, Array<ExportJob>& jobs, int& numSkipped)
+{
+    const var manifest = JSON::parse (manifestFile);
+    const var plugins = manifest.isArray() ? manifest : manifest.getProperty ("plugins", var());
+
+    if (! plugins.isArray())
+    {
+        std::cerr << "Could not read a list of plugins from " << manifestFile.getFullPathName() << "\n";
+        return false;
+    }
+
+    const File manifestDir = manifestFile.getParentDirectory();
+    const String defaultDestination = manifest.getProperty ("destination", "").toString();
+    std::map<String, int> jobIndices;
+    bool isValid = true;
+
+    for (const auto& plugin : *plugins.getArray())
+    {
+        const File csdFile = manifestDir.getChildFile (plugin.getProperty ("csd", "").toString());
+
+        if (! csdFile.existsAsFile())
+        {
+            std::cerr << "Skipping " << csdFile.getFullPathName() << ", it can't be found\n";
+            ++numSkipped;
+            continue;
+        }
+
+        const String destination = plugin.getProperty ("destination", defaultDestination).toString();
+        const File destinationDir = destination.isEmpty() ? csdFile.getParentDirectory() : manifestDir.getChildFile (destination);
+
+        //exports are named after the csd, so a csd listed more than once for the same destination is exported
+        //by a single job, and two csds with the same name can't share a destination
+        const String key = destinationDir.getChildFile (csdFile.getFileNameWithoutExtension()).getFullPathName();
+        auto existing = jobIndices.find (key);
+
+        if (existing == jobIndices.end())
+        {
+            //read once here rather than by every job
+            existing = jobIndices.emplace (key, jobs.size()).first;
+            jobs.add ({ csdFile, {}, getPluginInfo (csdFile, "id"), destinationDir });
+        }
+
+        auto& job = jobs.getReference (existing->second);
+
+        if (job.csdFile != csdFile)
+        {
+            std::cerr << csdFile.getFullPathName() << " and " << job.csdFile.getFullPathName() << " can't both be exported to "
+                      << destinationDir.getFullPathName() << ", they write the same files\n";
+            isValid = false;
+            continue;
+        }
+
+        if (auto* types = plugin.getProperty ("types", var()).getArray())
+        {
+            for (const auto& type : *types)
+            {
+                const String extension = PluginExporter::getPluginFileExtension (type.toString());
+
+                for (const auto& otherType : job.types)
+                {
+                    if (otherType != type.toString() && PluginExporter::getPluginFileExtension (otherType) == extension)
+                    {
+                        std::cerr << csdFile.getFullPathName() << " can't be exported as both " << otherType << " and " << type.toString()
+                                  << " to " << destinationDir.getFullPathName() << ", they write the same file\n";
+                        isValid = false;
+                    }
+                }
+
+                job.types.addIfNotAlreadyThere (type.toString());
+            }
+        }
+    }
+
+    if (! isValid)
+        return false;
+
+    for (const auto& job : jobs)
+        job.destination.createDirectory();
+
+    return true;
+}
+
+static int exportBatch (const File& manifestFile, int numThreads)
+{
+    Array<ExportJob> jobs;
+    int numSkipped = 0;
+
+    if (! readBatchManifest (manifestFile, jobs, numSkipped))
+        return 1;
+
+    //exporters hold look and feels, so they're created here rather than on the pool's threads
+    OwnedArray<PluginExporter> exporters;
+    for (int i = 0; i < jobs.size(); i++)
+        exporters.add (new PluginExporter());
+
+    CriticalSection outputLock;
+    std::atomic<int> numFailed { 0 };
+    ThreadPool pool (jmax (1, numThreads));
+    const uint32 startTime = Time::getMillisecondCounter();
+
+    std::cout << "Exporting " << jobs.size() << " plugins on " << pool.getNumThreads() << " threads\n";
+
+    for (int i = 0; i < jobs.size(); i++)
+    {
+        pool.addJob ([&, i]
+        {
+            const auto& job = jobs.getReference (i);
+
+            for (const auto& type : job.types)
+            {
+                const uint32 jobStartTime = Time::getMillisecondCounter();
+
+#if CabbagePro
+                const bool exported = exporters[i]->exportPlugin (type, job.csdFile, job.pluginId, job.destination.getFullPathName(), false, true);
+#else
+                const bool exported = exporters[i]->exportPlugin (type, job.csdFile, job.pluginId, job.destination.getFullPathName(), false, false);
+#endif
+
+                if (! exported)
+                    ++numFailed;
+
+                const ScopedLock sl (outputLock);
+                std::cout << job.csdFile.getFileName() << " (" << type << "): "
+                          << (exported ? String (Time::getMillisecondCounter() - jobStartTime) + "ms" : String ("failed")) << "\n";
+            }
+        });
+    }
+
+    while (pool.getNumJobs() > 0)
+        Thread::sleep (20);
+
+    std::cout << "Finished in " << String ((Time::getMillisecondCounter() - startTime) / 1000.0, 1) << "s\n";
+
+    if (numFailed > 0 || numSkipped > 0)
+    {
+        std::cerr << numFailed.load() << " exports failed, " << numSkipped << " csds skipped\n";
+        return 1;
+    }
+
+    return 0;
+}
+
 int main (int argc, char* argv[])
 {
     PluginExporter pluginExporter;
@@ -37,9 +207,25 @@ int main (int argc, char* argv[])
     
     std::cout << "Usage: CLIConverter --export-TYPE=\"name of csd file\" --destination=\"some absolute or relative dir\"\n";
     std::cout << "If you leave out the destination, exports will be placed into the same folder as the csd file\n\n";
-    std::cout << "Type can be one of the following: VST, VSTi, VST3, VST3i, AUMIDIFx, AUi, and AU";
+    std::cout << "Type can be one of the following: VST, VSTi, VST3, VST3i, AUMIDIFx, AUi, and AU\n\n";
+    std::cout << "Or: CLIConverter --batch=\"manifest.json\" [--jobs=N] to export a list of csds in parallel\n";
+
+    String manifest;
+    int numThreads = SystemStats::getNumCpus();
+
+    for (int i = 1; i < argc; i++)
+    {
+        const String arg (argv[i]);
+
+        if (arg.startsWith ("--batch="))
+            manifest = arg.fromFirstOccurrenceOf ("=", false, false).unquoted();
+        else if (arg.startsWith ("--jobs="))
+            numThreads = arg.fromFirstOccurrenceOf ("=", false, false).getIntValue();
+    }
+
+    if (manifest.isNotEmpty())
+        return exportBatch (File::getCurrentWorkingDirectory().getChildFile (manifest), numThreads);
 
-    
     for( int i = 1 ; i < argc ; i++)
     {
         args.append(argv[i], 1000);
@@ -70,12 +256,12 @@ int main (int argc, char* argv[])
 
     
 #if CabbagePro
-    pluginExporter.exportPlugin (type, csdFile,  getPluginInfo (csdFile, "id"), pluginDestination.getFullPathName(), false, true);
+    const bool exported = pluginExporter.exportPlugin (type, csdFile,  getPluginInfo (csdFile, "id"), pluginDestination.getFullPathName(), false, true);
 #else
-    pluginExporter.exportPlugin (type, csdFile,  getPluginInfo (csdFile, "id"), pluginDestination.getFullPathName(), false, false);
+    const bool exported = pluginExporter.exportPlugin (type, csdFile,  getPluginInfo (csdFile, "id"), pluginDestination.getFullPathName(), false, false);
 #endif
     
     
     
-    return 0;
+    return exported ? 0 : 1;
 }
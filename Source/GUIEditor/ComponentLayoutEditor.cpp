@@ -111,6 +111,11 @@ void ComponentLayoutEditor::setComponentBoundsProperties (Component* child, juce
     child->getProperties().set ("originalHeight", bounds.getHeight());
 }
 
+void ComponentLayoutEditor::overlayBoundsChanged (ComponentOverlay* overlay)
+{
+    overlayIndex.update (overlay, overlay->getBounds());
+}
+
 //==================================================================================================================
 void ComponentLayoutEditor::updateCodeEditor()
 {
@@ -243,20 +248,8 @@ void ComponentLayoutEditor::mouseDown (const MouseEvent& e)
 //==================================================================================================================
 void ComponentLayoutEditor::findLassoItemsInArea (Array <ComponentOverlay*>& results, const juce::Rectangle<int>& area)
 {
-    const juce::Rectangle<int> lasso (area);
-
-    for (int i = 0; i < getNumChildComponents() - 1; i++)
-    {
-        ComponentOverlay* c = (ComponentOverlay*)getChildComponent (i);
-
-        if (c->getBounds().intersects (lasso))
-        {
-            results.addIfNotAlreadyThere (c);
-            selectedComponents.addToSelection (c);
-        }
-        else
-            selectedComponents.deselect (c);
-    }
+    //the lasso component sets the selection to whatever ends up in results
+    overlayIndex.findItemsInArea (area, results);
 }
 
 SelectedItemSet <ComponentOverlay*>& ComponentLayoutEditor::getLassoSelection()
@@ -296,7 +289,20 @@ void ComponentLayoutEditor::bindWithTarget ()
 void ComponentLayoutEditor::updateFrames ()
 {
     selectedComponents.deselectAll();
-    frames.clear ();
+
+    //widgets that already have an overlay keep it, so a bounds change doesn't rebuild every overlay
+    std::unordered_map<const Component*, ComponentOverlay*> oldFrames;
+
+    for (auto* frame : frames)
+    {
+        if (frame->getTarget() != nullptr && oldFrames.find (frame->getTarget()) == oldFrames.end())
+            oldFrames[frame->getTarget()] = frame;
+        else
+            delete frame;
+    }
+
+    frames.clearQuick (false);
+    overlayIndex.clear();
 
     if (target != NULL)
     {
@@ -309,18 +315,33 @@ void ComponentLayoutEditor::updateFrames ()
 
             if (c)
             {
-                ComponentOverlay* alias = createAlias (c);
+                ComponentOverlay* alias = nullptr;
+                const auto existing = oldFrames.find (c);
+
+                if (existing != oldFrames.end() && existing->second != nullptr)
+                {
+                    alias = existing->second;
+                    existing->second = nullptr;
+                    alias->updateFromTarget();
+                }
+                else if ((alias = createAlias (c)) != nullptr)
+                {
+                    addAndMakeVisible (alias);
+                }
 
                 if (alias)
                 {
                     alias->setName (c->getName());
                     setComponentBoundsProperties (alias, alias->getBounds());
                     frames.add (alias);
-                    addAndMakeVisible (alias);
+                    overlayIndex.update (alias, alias->getBounds());
                 }
             }
         }
     }
+
+    for (auto& oldFrame : oldFrames)
+        delete oldFrame.second;
 }
 
 void ComponentLayoutEditor::enablementChanged ()
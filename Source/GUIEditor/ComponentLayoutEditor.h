@@ -22,6 +22,7 @@
  */
 
 #include "../CabbageCommonHeaders.h"
+#include "ComponentSpatialIndex.h"
 
 class ComponentOverlay;
 class CabbagePluginEditor;
@@ -59,6 +60,7 @@ public:
     void updateCodeEditor();
     void updateSelectedComponentBounds();
     void setComponentBoundsProperties (Component* child, juce::Rectangle<int> bounds);
+    void overlayBoundsChanged (ComponentOverlay* overlay);
 
     SelectedItemSet <ComponentOverlay*>& getLassoSelection() override;
     LassoComponent <ComponentOverlay*> lassoComp;
@@ -72,6 +74,7 @@ public:
 private:
     virtual ComponentOverlay* createAlias (Component* child);
     SafePointer<Component> target;
+    ComponentSpatialIndex<ComponentOverlay*> overlayIndex;
     OwnedArray<ComponentOverlay> frames;
     CabbageLookAndFeel2 lookAndFeel;
 
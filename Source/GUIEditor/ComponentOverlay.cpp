@@ -39,6 +39,7 @@ void ComponentOverlay::resized ()
     setWantsKeyboardFocus (true);
 
     resizer->setBounds (0, 0, getWidth(), getHeight());
+    layoutEditor->overlayBoundsChanged (this);
 
     if (resizer->isMouseButtonDown ())
     {
@@ -46,6 +47,11 @@ void ComponentOverlay::resized ()
     }
 }
 
+void ComponentOverlay::moved ()
+{
+    layoutEditor->overlayBoundsChanged (this);
+}
+
 void ComponentOverlay::paint (Graphics& g)
 {
 
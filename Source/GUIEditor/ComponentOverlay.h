@@ -25,6 +25,7 @@ public:
     ComponentOverlay (Component* targetChild, ComponentLayoutEditor* layoutEditor);
     ~ComponentOverlay () override;
     void resized () override;
+    void moved () override;
     void paint (Graphics& g) override;
     const Component* getTargetChild ();
     void updateFromTarget ();
@@ -0,0 +1,131 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef COMPONENTSPATIALINDEX_H_INCLUDED
+#define COMPONENTSPATIALINDEX_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <unordered_map>
+#include <unordered_set>
+
+//==============================================================================
+// A uniform grid over item bounds. Each item is stored in every cell its
+// bounds touch, so finding what lies under a lasso only looks at the cells
+// the lasso covers rather than at every item. Items are moved between cells
+// when their bounds change.
+//==============================================================================
+template <typename ItemType>
+class ComponentSpatialIndex
+{
+public:
+    explicit ComponentSpatialIndex (int gridCellSize = 64) : cellSize (gridCellSize) {}
+
+    void clear()
+    {
+        cells.clear();
+        itemBounds.clear();
+    }
+
+    //adds the item, or moves it if it's already indexed
+    void update (ItemType item, juce::Rectangle<int> bounds)
+    {
+        const auto existing = itemBounds.find (item);
+
+        if (existing != itemBounds.end())
+        {
+            if (existing->second == bounds)
+                return;
+
+            removeFromCells (item, existing->second);
+            existing->second = bounds;
+        }
+        else
+        {
+            itemBounds.emplace (item, bounds);
+        }
+
+        addToCells (item, bounds);
+    }
+
+    //every item whose bounds intersect the area, in no particular order
+    void findItemsInArea (juce::Rectangle<int> area, Array<ItemType>& results) const
+    {
+        std::unordered_set<ItemType> found;
+
+        forEachCell (area, [&] (int64 key)
+        {
+            const auto cell = cells.find (key);
+
+            if (cell == cells.end())
+                return;
+
+            for (auto item : cell->second)
+                if (itemBounds.at (item).intersects (area) && found.insert (item).second)
+                    results.add (item);
+        });
+    }
+
+private:
+    static int floorDiv (int value, int divisor)
+    {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    template <typename Callback>
+    void forEachCell (juce::Rectangle<int> bounds, Callback&& callback) const
+    {
+        const int left = floorDiv (bounds.getX(), cellSize);
+        const int top = floorDiv (bounds.getY(), cellSize);
+        const int right = floorDiv (jmax (bounds.getX(), bounds.getRight() - 1), cellSize);
+        const int bottom = floorDiv (jmax (bounds.getY(), bounds.getBottom() - 1), cellSize);
+
+        for (int x = left; x <= right; x++)
+            for (int y = top; y <= bottom; y++)
+                callback ((int64 (x) << 32) | (int64) (uint32) y);
+    }
+
+    void addToCells (ItemType item, juce::Rectangle<int> bounds)
+    {
+        forEachCell (bounds, [&] (int64 key) { cells[key].add (item); });
+    }
+
+    void removeFromCells (ItemType item, juce::Rectangle<int> bounds)
+    {
+        forEachCell (bounds, [&] (int64 key)
+        {
+            const auto cell = cells.find (key);
+
+            if (cell == cells.end())
+                return;
+
+            cell->second.removeFirstMatchingValue (item);
+
+            if (cell->second.isEmpty())
+                cells.erase (cell);
+        });
+    }
+
+    const int cellSize;
+    std::unordered_map<int64, Array<ItemType>> cells;
+    std::unordered_map<ItemType, juce::Rectangle<int>> itemBounds;
+
+    JUCE_DECLARE_NON_COPYABLE (ComponentSpatialIndex)
+};
+
+#endif  // COMPONENTSPATIALINDEX_H_INCLUDED
@@ -18,6 +18,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
 */
 
 #include "CabbageLookAndFeel2.h"
+#include "CabbageSVGCache.h"
 
 namespace LookAndFeelHelpers
 {
@@ -1226,18 +1227,19 @@ void CabbageLookAndFeel2::drawFromSVG(Graphics& g, File svgFile, int x, int y, i
 {
     if(svgFile.existsAsFile())
     {
-        std::unique_ptr<XmlElement> svg(XmlDocument::parse(svgFile.loadFileAsString()));
+        //this gets called on every repaint, so the parsed file is shared rather than read each time
+        SharedResourcePointer<CabbageSVGCache> cache;
+        std::shared_ptr<const Drawable> drawable = cache->getDrawable(svgFile);
 
-        if (svg == nullptr)
+        if (drawable == nullptr)
             jassert(false);
 
-        std::unique_ptr<Drawable> drawable;
-
-        if (svg != nullptr)
+        if (drawable != nullptr)
         {
-            drawable = Drawable::createFromSVG(*svg);
-            drawable->setTransformToFit(juce::Rectangle<float>(x, y, newWidth, newHeight), RectanglePlacement::stretchToFit);
-            drawable->draw(g, 1.f, affine);
+            //the shared drawable isn't modified, the fit is applied as part of the transform instead
+            const AffineTransform fit = RectanglePlacement(RectanglePlacement::stretchToFit)
+                                            .getTransformToFit(drawable->getDrawableBounds(), juce::Rectangle<float>(x, y, newWidth, newHeight));
+            drawable->draw(g, 1.f, fit.followedBy(affine));
         }
     }
 }
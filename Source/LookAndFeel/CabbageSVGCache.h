@@ -0,0 +1,90 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGESVGCACHE_H_INCLUDED
+#define CABBAGESVGCACHE_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <unordered_map>
+
+//==============================================================================
+// Parsed SVG files for the look and feels, which draw them on every repaint.
+// Raster images are already shared through JUCE's ImageCache, this does the
+// same for SVGs. A file is only checked for changes on disk once a second at
+// most, and the least recently used drawables are dropped once there are
+// more than maxNumDrawables of them.
+//==============================================================================
+class CabbageSVGCache
+{
+public:
+    static constexpr int maxNumDrawables = 64;
+    static constexpr uint32 recheckIntervalMs = 1000;
+
+    std::shared_ptr<const Drawable> getDrawable (const File& svgFile)
+    {
+        const ScopedLock sl (lock);
+        const uint32 now = Time::getMillisecondCounter();
+        auto& svg = svgs[svgFile.getFullPathName().toStdString()];
+
+        if (svg.drawable == nullptr || now - svg.lastChecked >= recheckIntervalMs)
+        {
+            const Time lastModified = svgFile.getLastModificationTime();
+            svg.lastChecked = now;
+
+            if (svg.drawable == nullptr || svg.lastModified != lastModified)
+            {
+                std::unique_ptr<XmlElement> xml (XmlDocument::parse (svgFile.loadFileAsString()));
+                svg.drawable = xml != nullptr ? std::shared_ptr<const Drawable> (Drawable::createFromSVG (*xml)) : nullptr;
+                svg.lastModified = lastModified;
+            }
+        }
+
+        svg.lastUsed = now;
+        auto drawable = svg.drawable;
+
+        if ((int) svgs.size() > maxNumDrawables)
+            removeLeastRecentlyUsed (now);
+
+        return drawable;
+    }
+
+private:
+    struct CachedSVG
+    {
+        std::shared_ptr<const Drawable> drawable;
+        Time lastModified;
+        uint32 lastChecked = 0, lastUsed = 0;
+    };
+
+    void removeLeastRecentlyUsed (uint32 now)
+    {
+        auto oldest = svgs.begin();
+
+        for (auto it = svgs.begin(); it != svgs.end(); ++it)
+            if (now - it->second.lastUsed > now - oldest->second.lastUsed)
+                oldest = it;
+
+        svgs.erase (oldest);
+    }
+
+    CriticalSection lock;
+    std::unordered_map<std::string, CachedSVG> svgs;
+};
+
+#endif  // CABBAGESVGCACHE_H_INCLUDED
@@ -7,125 +7,258 @@
 
 #include "CabbageFileReaderOpcodes.h"
 
+//====================================================================================================
+std::shared_ptr<const AudioBuffer<float>> CabbageFileReaderCache::getOrLoad (const File& file, AudioFormatReader& reader)
+{
+    const ScopedLock sl (lock);
+    const String path = file.getFullPathName();
+    const Time lastModified = file.getLastModificationTime();
+
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if (it->path == path && it->lastModified == lastModified)
+        {
+            entries.splice (entries.begin(), entries, it);
+            return entries.front().buffer;
+        }
+    }
+
+    auto buffer = std::make_shared<AudioBuffer<float>> ((int) reader.numChannels, (int) reader.lengthInSamples);
+    reader.read (buffer.get(), 0, (int) reader.lengthInSamples, 0, true, true);
+
+    entries.push_front ({ path, lastModified, buffer });
+    cacheSizeInBytes += getSizeInBytes (*buffer);
+
+    //instances still playing an evicted file keep their own reference to it
+    while (cacheSizeInBytes > maxCacheSizeInBytes && entries.size() > 1)
+    {
+        cacheSizeInBytes -= getSizeInBytes (*entries.back().buffer);
+        entries.pop_back();
+    }
+
+    return buffer;
+}
+
+//====================================================================================================
+CabbageFileStreamer::CabbageFileStreamer (std::unique_ptr<AudioFormatReader> fileReader, int64 startSample, bool shouldLoop, int ringBufferSize)
+    : reader (std::move (fileReader)),
+      ringBuffer ((int) reader->numChannels, ringBufferSize),
+      fifo (ringBufferSize),
+      readerPosition (jlimit ((int64) 0, reader->lengthInSamples, startSample)),
+      loop (shouldLoop)
+{
+    //fill some of the buffer straight away so the first few k-cycles aren't silent
+    fillRingBuffer();
+    thread->addTimeSliceClient (this);
+}
+
+CabbageFileStreamer::~CabbageFileStreamer()
+{
+    thread->removeTimeSliceClient (this);
+}
+
+int CabbageFileStreamer::useTimeSlice()
+{
+    if (endOfFile.load())
+        return 100;
+
+    return fillRingBuffer() > 0 ? 1 : 10;
+}
+
+int CabbageFileStreamer::fillRingBuffer()
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (jmin (fifo.getFreeSpace(), 8192), start1, size1, start2, size2);
+
+    int numWritten = 0;
 
+    for (auto block : { Range<int> (start1, start1 + size1), Range<int> (start2, start2 + size2) })
+    {
+        int destPosition = block.getStart();
+
+        while (destPosition < block.getEnd())
+        {
+            if (readerPosition >= reader->lengthInSamples)
+            {
+                if (! loop || reader->lengthInSamples == 0)
+                {
+                    endOfFile = true;
+                    fifo.finishedWrite (numWritten);
+                    return numWritten;
+                }
+
+                readerPosition = 0;
+            }
+
+            const int numToRead = (int) jmin ((int64) (block.getEnd() - destPosition), reader->lengthInSamples - readerPosition);
+            reader->read (&ringBuffer, destPosition, numToRead, readerPosition, true, true);
+            readerPosition += numToRead;
+            destPosition += numToRead;
+            numWritten += numToRead;
+        }
+    }
+
+    fifo.finishedWrite (numWritten);
+    return numWritten;
+}
+
+int CabbageFileStreamer::peek (AudioBuffer<float>& dest, int maxSamples)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (jmin (maxSamples, dest.getNumSamples()), start1, size1, start2, size2);
+
+    const int numChannels = jmin (dest.getNumChannels(), ringBuffer.getNumChannels());
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        if (size1 > 0)
+            dest.copyFrom (channel, 0, ringBuffer, channel, start1, size1);
+        if (size2 > 0)
+            dest.copyFrom (channel, size1, ringBuffer, channel, start2, size2);
+    }
+
+    return size1 + size2;
+}
+
+//====================================================================================================
 int CabbageFileReader::init()
 {
-    if(!File::getCurrentWorkingDirectory().getChildFile(inargs.str_data(0).data).existsAsFile()){
+    const File audioFile = File::getCurrentWorkingDirectory().getChildFile (inargs.str_data(0).data);
+
+    if(!audioFile.existsAsFile()){
+        csound->init_error("Could not open audio file. Please make sure you provide a full path\n");
+        return NOTOK;
+    }
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (audioFile));
+
+    if (reader == nullptr || reader->numChannels == 0) {
         csound->init_error("Could not open audio file. Please make sure you provide a full path\n");
         return NOTOK;
     }
 
     csound->plugin_deinit(this);
-    resample = std::make_unique<LagrangeInterpolator>();
-    loopMode = static_cast<int>(inargs[3]);
-    skipTime = static_cast<int>(inargs[2]);
-    loopEnded = false;
-    
-    std::ifstream stream;
-    stream.open(inargs.str_data(0).data, std::ios::binary);
-        
-    const ov_callbacks callbacks{read, seek, nullptr, tell};
-    int result = ov_open_callbacks(&stream, &file, nullptr, 0, callbacks);
-    if (result < 0) {
-        csound->init_error("Could not open ogg file. Please make sure you provide a full path\n");
-        return 0;
-    }
-
-    vorbis_info* vorbisInfo = ov_info(&file, -1);
-    
-    
-    numChannels = vorbisInfo->channels; // Stereo audio
-    long pcm_size = 1024; // Number of samples to read at a time
-    float** pcm;
-    
-    pcm = (float**)malloc(sizeof(float*) * numChannels);
-    for (int i = 0; i < numChannels; i++) {
-        pcm[i] = (float*)malloc(sizeof(float) * pcm_size);
-    }
-
-    
-    int bitstream;
-    long samples;
-
-    
-    numSamples = ov_pcm_total(&file, -1);
-    audioBuffer.clear();
-    audioBuffer.setSize(numChannels, numSamples);
-    ov_time_seek_lap(&file, 0);
-    auto buf = audioBuffer.getArrayOfWritePointers();
-
-    for( int i = 0 ; i < 16 ; i++)
-        sampleIndex[i] = 0;
-    
-    while ((samples = ov_read_float(&file, &pcm, pcm_size, &bitstream)) > 0)
-    {
-        for (int channel = 0; channel < numChannels; channel++) {
+    state = std::make_unique<State>();
+    state->numChannels = (int) reader->numChannels;
+    state->sampleRateRatio = reader->sampleRate / csound->sr();
+    state->loop = static_cast<int>(inargs[3]) != 0;
+    state->outputBuffer.setSize (state->numChannels, (int) nsmps);
+    state->interpolators.resize ((size_t) state->numChannels);
+    state->input.resize ((size_t) state->numChannels);
 
-            for (long j = 0; j < samples; j++) {
-                if((int)sampleIndex[channel]<numSamples)
-                    buf[channel][(int)sampleIndex[channel]++] = pcm[channel][j];
-            }
-        }
+    const int64 startSample = (int64) (inargs[2] * reader->sampleRate);
+    const double lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
+
+    if (lengthInSeconds <= CabbageFileReaderCache::maxCachedFileLengthInSeconds)
+    {
+        state->cachedFile = state->cache->getOrLoad (audioFile, *reader);
+        state->readPosition = (int) jlimit ((int64) 0, reader->lengthInSamples, startSample);
+    }
+    else
+    {
+        //enough room for half a second of audio at the highest playback rate
+        const int ringBufferSize = jmax (16384, (int) (reader->sampleRate * 4.0));
+        state->streamBuffer.setSize (state->numChannels, (int) std::ceil (nsmps * state->sampleRateRatio * 8.0) + 8);
+        state->streamer = std::make_unique<CabbageFileStreamer> (std::move (reader), startSample, state->loop, ringBufferSize);
     }
-    
-    resampleBuffer((double)vorbisInfo->rate/(double)csound->sr(), audioBuffer, audioBuffer.getNumChannels());
-    
-    for( int i = 0 ; i < 16 ; i++)
-        sampleIndex[i] = 0;
+
     return OK;
 }
 
 int CabbageFileReader::deinit(){
-    
-    ov_clear (&file);
-    audioBuffer.clear();
-    
-    return OK;
-}
 
-void CabbageFileReader::resampleBuffer(double ratio, AudioBuffer<float>& buffer, int numChannels)
-{
-    
-    AudioBuffer<float> temp;
-    temp.clear();//zero contents
-    temp.setSize(numChannels, (int)(buffer.getNumSamples() / ratio));
-    const float** inputs = buffer.getArrayOfReadPointers();
-    float** outputs = temp.getArrayOfWritePointers();
-    resample->process(ratio, inputs[0], outputs[0], temp.getNumSamples());
-    if(numChannels == 2)
-        resample->process(ratio, inputs[1], outputs[1], temp.getNumSamples());
-    buffer = temp;
-    
-    
+    //stops the background decoding before the ring buffer goes away
+    state.reset();
+    return OK;
 }
 
 int CabbageFileReader::aperf()
 {
-    playbackRate = inargs[1];
-    for (int channel = 0; channel < numChannels; ++channel)
+    //sample-accurate starts and ends leave the head and tail of the block silent
+    const int blockSize = (int) insdshead->ksmps;
+    const int offset = jmin ((int) insdshead->ksmps_offset, blockSize);
+    const int early = jmin ((int) insdshead->ksmps_no_end, blockSize - offset);
+    const int numSamples = blockSize - offset - early;
+    const int numOutputs = jmin (out_count(), maxOutputs);
+
+    for (int i = 0; i < numOutputs; i++)
+    {
+        std::fill (outargs(i), outargs(i) + offset, 0);
+        std::fill (outargs(i) + offset + numSamples, outargs(i) + blockSize, 0);
+    }
+
+    if (state == nullptr || state->finished)
+    {
+        for (int i = 0; i < numOutputs; i++)
+            std::fill (outargs(i) + offset, outargs(i) + offset + numSamples, 0);
+
+        return OK;
+    }
+
+    //playback rate is relative to the file's own sample rate, so conversion to Csound's rate happens here
+    const double ratio = jlimit (0.0, 8.0, (double) inargs[1]) * state->sampleRateRatio;
+    const int numChannels = state->numChannels;
+    int numAvailable = 0, wrapAround = 0;
+
+    if (state->cachedFile != nullptr)
+    {
+        //looping files wrap back to the start inside the interpolator, so there's no gap at the loop point
+        numAvailable = state->cachedFile->getNumSamples() - state->readPosition;
+        wrapAround = state->loop ? state->cachedFile->getNumSamples() : 0;
+
+        for (int channel = 0; channel < numChannels && numAvailable > 0; channel++)
+            state->input[(size_t) channel] = state->cachedFile->getReadPointer (channel, state->readPosition);
+    }
+    else
     {
-        auto channelSamples = audioBuffer.getArrayOfWritePointers();
-        // auto* channelData = buffer.getWritePointer (channel);
-        csnd::AudioSig out(this, outargs(channel));
-        for( int i = 0 ; i < out.GetNsmps() ; i++, sampleIndex[channel]+=playbackRate)
+        numAvailable = state->streamer->peek (state->streamBuffer, state->streamBuffer.getNumSamples());
+        for (int channel = 0; channel < numChannels; channel++)
+            state->input[(size_t) channel] = state->streamBuffer.getReadPointer (channel);
+    }
+
+    //every channel runs at the same ratio, so they all consume the same number of input samples
+    int numUsed = 0;
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        float* output = state->outputBuffer.getWritePointer (channel);
+
+        if (numAvailable > 0)
+            numUsed = state->interpolators[(size_t) channel].process (ratio, state->input[(size_t) channel], output, numSamples, numAvailable, wrapAround);
+        else
+            FloatVectorOperations::clear (output, numSamples);
+    }
+
+    for (int i = 0; i < numOutputs; i++)
+    {
+        const float* source = state->outputBuffer.getReadPointer (jmin (i, numChannels - 1));
+        MYFLT* dest = outargs(i) + offset;
+
+        for (int n = 0; n < numSamples; n++)
+            dest[n] = source[n];
+    }
+
+    if (state->cachedFile != nullptr)
+    {
+        const int fileLength = state->cachedFile->getNumSamples();
+
+        if (state->loop && fileLength > 0)
         {
-            if(!loopEnded)
-            {
-                auto s = int(sampleIndex[channel]);
-                out[i] = channelSamples[channel][int(sampleIndex[channel])];
-                if((int)sampleIndex[channel]>=numSamples)
-                {
-                    sampleIndex[channel] = 0;
-                    if(loopMode == 0)
-                        loopEnded = true;
-                }
-            }
-            else{
-                out[i] = 0;
-            }
+            state->readPosition = ((state->readPosition + numUsed) % fileLength + fileLength) % fileLength;
+        }
+        else
+        {
+            state->readPosition += numUsed;
+            state->finished = state->readPosition >= fileLength;
         }
     }
-    
+    else
+    {
+        state->streamer->finishedReading (numUsed);
+        state->finished = state->streamer->hasFinished();
+    }
+
     return OK;
 }
-    
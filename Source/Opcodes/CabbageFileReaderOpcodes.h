@@ -8,54 +8,112 @@
 
 #include "JuceHeader.h"
 
-#include "../../JUCE/modules/juce_audio_formats/codecs/oggvorbis/vorbisenc.h"
-#include "../../JUCE/modules/juce_audio_formats/codecs/oggvorbis/codec.h"
-#include "../../JUCE/modules/juce_audio_formats/codecs/oggvorbis/vorbisfile.h"
+#include <list>
 
 
-struct CabbageFileReader : csnd::Plugin<2, 4>
+//====================================================================================================
+// Files shorter than this are decoded in full once and shared between instances, anything longer
+// is streamed from disk by a background thread.
+//====================================================================================================
+class CabbageFileReaderCache
 {
-    AudioBuffer<float> audioBuffer;
-    File audioFile = {};
-    int init();
-    int aperf();
-    int deinit();    float playbackRate = 1;
-    int loopMode = 0;
-    int skipTime = 0;
-    float sampleIndex[16] = {0};
-    bool loopEnded = false;
-    std::unique_ptr<LagrangeInterpolator> resample;
-    OggVorbis_File file;
-    int numSamples = 0;
-    int numChannels = 0;
-    static size_t read(void* buffer, size_t elementSize, size_t elementCount, void* dataSource) {
-        assert(elementSize == 1);
-
-        std::ifstream& stream = *static_cast<std::ifstream*>(dataSource);
-        stream.read(static_cast<char*>(buffer), elementCount);
-        const std::streamsize bytesRead = stream.gcount();
-        stream.clear(); // In case we read past EOF
-        return static_cast<size_t>(bytesRead);
+public:
+    static constexpr double maxCachedFileLengthInSeconds = 10.0;
+    static constexpr size_t maxCacheSizeInBytes = 64 * 1024 * 1024;
+
+    std::shared_ptr<const AudioBuffer<float>> getOrLoad (const File& file, AudioFormatReader& reader);
+
+private:
+    struct Entry
+    {
+        String path;
+        Time lastModified;
+        std::shared_ptr<const AudioBuffer<float>> buffer;
+    };
+
+    static size_t getSizeInBytes (const AudioBuffer<float>& buffer)
+    {
+        return (size_t) buffer.getNumChannels() * (size_t) buffer.getNumSamples() * sizeof (float);
     }
 
-    static int seek(void* dataSource, ogg_int64_t offset, int origin) {
-        static const std::vector<std::ios_base::seekdir> seekDirections{
-            std::ios_base::beg, std::ios_base::cur, std::ios_base::end
-        };
+    CriticalSection lock;
+    std::list<Entry> entries;   //most recently used first
+    size_t cacheSizeInBytes = 0;
+};
 
-        std::ifstream& stream = *static_cast<std::ifstream*>(dataSource);
-        stream.seekg(offset, seekDirections.at(origin));
-        stream.clear(); // In case we seeked to EOF
-        return 0;
+//====================================================================================================
+class CabbageFileReaderThread : public TimeSliceThread
+{
+public:
+    CabbageFileReaderThread() : TimeSliceThread ("cabbageFileReader")
+    {
+        startThread (5);
     }
 
-    static long tell(void* dataSource) {
-        std::ifstream& stream = *static_cast<std::ifstream*>(dataSource);
-        const auto position = stream.tellg();
-        assert(position >= 0);
-        return static_cast<long>(position);
+    ~CabbageFileReaderThread() override
+    {
+        stopThread (1000);
     }
+};
+
+//====================================================================================================
+// Decodes a file on the shared reader thread into a lock-free ring buffer that the opcode reads from
+// on the performance thread. Looping is handled here so the wrap point is seamless.
+//====================================================================================================
+class CabbageFileStreamer : public TimeSliceClient
+{
+public:
+    CabbageFileStreamer (std::unique_ptr<AudioFormatReader> fileReader, int64 startSample, bool shouldLoop, int ringBufferSize);
+    ~CabbageFileStreamer() override;
 
-        
-    void resampleBuffer(double ratio, AudioBuffer<float>& buffer, int numChannels);
+    int useTimeSlice() override;
+
+    //performance thread, copies what's ready into dest without consuming it
+    int peek (AudioBuffer<float>& dest, int maxSamples);
+    void finishedReading (int numSamples)     {   fifo.finishedRead (numSamples);    }
+    bool hasFinished() const                  {   return endOfFile.load() && fifo.getNumReady() == 0;  }
+
+private:
+    int fillRingBuffer();
+
+    SharedResourcePointer<CabbageFileReaderThread> thread;
+    std::unique_ptr<AudioFormatReader> reader;
+    AudioBuffer<float> ringBuffer;
+    AbstractFifo fifo;
+    int64 readerPosition = 0;
+    const bool loop;
+    std::atomic<bool> endOfFile { false };
+};
+
+//====================================================================================================
+// a1 [, a2, ...] cabbageFileReader Sfile, kspeed, iskiptime, iloop
+//
+// Any number of outputs up to maxOutputs. Each output plays the file channel of the same index, and
+// outputs beyond the file's channel count repeat its last channel, so a mono file still fills both
+// sides of a stereo pair.
+//====================================================================================================
+struct CabbageFileReader : csnd::Plugin<32, 4>
+{
+    static constexpr int maxOutputs = 32;
+
+    //Csound doesn't run constructors for opcode data, so everything that needs one lives in here
+    struct State
+    {
+        SharedResourcePointer<CabbageFileReaderCache> cache;
+        std::shared_ptr<const AudioBuffer<float>> cachedFile;
+        std::unique_ptr<CabbageFileStreamer> streamer;
+        AudioBuffer<float> streamBuffer, outputBuffer;
+        std::vector<LagrangeInterpolator> interpolators;   //one per file channel
+        std::vector<const float*> input;
+        int numChannels = 0;
+        int readPosition = 0;
+        double sampleRateRatio = 1;
+        bool loop = false;
+        bool finished = false;
+    };
+
+    std::unique_ptr<State> state;
+    int init();
+    int aperf();
+    int deinit();
 };
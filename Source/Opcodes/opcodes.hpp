@@ -792,6 +792,7 @@ struct ChannelStateSave : csnd::Plugin<1, 1>
         ignoreStrings.push_back("CURRENT_DATE_TIME");
         ignoreStrings.push_back("SECONDS_SINCE_EPOCH");
         ignoreStrings.push_back("HOST_BUFFER_SIZE");
+        ignoreStrings.push_back("CURRENT_KSMPS");
         ignoreStrings.push_back("LAST_FILE_DROPPED");
         ignoreStrings.push_back("SECONDS_SINCE_EPOCH");
         ignoreStrings.push_back("SECONDS_SINCE_EPOCH");
@@ -122,6 +122,8 @@ void CabbageSettings::setDefaultSettings()
     defaultPropSet->setValue ("windowX", 100);
     defaultPropSet->setValue ("windowY", 100);
     defaultPropSet->setValue ("RecordingBitDepth", 32);
+    defaultPropSet->setValue ("RecordingFormat", "wav");
+    defaultPropSet->setValue ("RecordingStems", "");
 
 	//=====================================================================
 	defaultPropSet->setValue("AudioDriversWarning_dismiss", 0);
@@ -337,6 +337,10 @@ void CabbageSettingsWindow::addMiscProperties()
 
     const int bitDepth = settings.getUserSettings()->getIntValue ("RecordingBitDepth");
     editorProps.add (new TextPropertyComponent (Value (bitDepth), "Recording bit-depth", 10, false));
+    const String recordingFormat = settings.getUserSettings()->getValue ("RecordingFormat");
+    editorProps.add (new TextPropertyComponent (Value (recordingFormat), "Recording format (wav or flac)", 10, false));
+    const String recordingStems = settings.getUserSettings()->getValue ("RecordingStems");
+    editorProps.add (new TextPropertyComponent (Value (recordingStems), "Recording stems (buses and/or Csound audio channels)", 200, false));
     
     const String examplesDir = settings.getUserSettings()->getValue ("CabbageExamplesDir");
     
@@ -397,6 +401,10 @@ void CabbageSettingsWindow::textPropertyComponentChanged (TextPropertyComponent*
 		settings.getUserSettings()->setValue("UDP Port", comp->getValue().toString());
     else if (comp->getName() == "Recording bit-depth")
         settings.getUserSettings()->setValue("RecordingBitDepth", comp->getValue().toString());
+    else if (comp->getName() == "Recording format (wav or flac)")
+        settings.getUserSettings()->setValue("RecordingFormat", comp->getValue().toString());
+    else if (comp->getName() == "Recording stems (buses and/or Csound audio channels)")
+        settings.getUserSettings()->setValue("RecordingStems", comp->getValue().toString());
 }
 
 void CabbageSettingsWindow::resized()
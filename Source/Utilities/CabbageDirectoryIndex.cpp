@@ -0,0 +1,315 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CabbageDirectoryIndex.h"
+
+//==============================================================================
+CabbageDirectoryIndex::CabbageDirectoryIndex() : Thread ("Cabbage directory index")
+{
+    startThread (1);
+}
+
+CabbageDirectoryIndex::~CabbageDirectoryIndex()
+{
+    fileWatcher->removeListener (this);
+    signalThreadShouldExit();
+    notify();
+    stopThread (4000);
+    cancelPendingUpdate();
+}
+
+//==============================================================================
+Array<File> CabbageDirectoryIndex::setDirectory (Listener* listener, const File& directory, const String& wildcard, int whatToLookFor)
+{
+    bool isNew = false;
+    Array<File> files;
+
+    {
+        const ScopedLock sl (lock);
+        auto* index = findOrCreateIndex (directory, wildcard, whatToLookFor, isNew);
+        bool found = false;
+
+        for (auto& l : listeners)
+        {
+            if (l.listener == listener)
+            {
+                l.index = index;
+                found = true;
+            }
+        }
+
+        if (! found)
+            listeners.add ({ listener, index });
+
+        files = index->files;
+    }
+
+    if (isNew)
+    {
+        updateWatchedDirectories();
+        notify();
+    }
+
+    return files;
+}
+
+void CabbageDirectoryIndex::removeListener (Listener* listener)
+{
+    const ScopedLock sl (lock);
+
+    for (int i = listeners.size(); --i >= 0;)
+        if (listeners.getReference (i).listener == listener)
+            listeners.remove (i);
+}
+
+void CabbageDirectoryIndex::rescan (Listener* listener)
+{
+    {
+        const ScopedLock sl (lock);
+
+        for (const auto& l : listeners)
+        {
+            if (l.listener == listener)
+            {
+                //a listing already underway may have started before whatever prompted this
+                ++l.index->generation;
+                l.index->isUpToDate = false;
+                l.index->needsScan = true;
+            }
+        }
+    }
+
+    notify();
+}
+
+Array<File> CabbageDirectoryIndex::getFiles (const File& directory, const String& wildcard, int whatToLookFor)
+{
+    bool isNew = false;
+    Index* index;
+    int generation;
+
+    {
+        const ScopedLock sl (lock);
+        index = findOrCreateIndex (directory, wildcard, whatToLookFor, isNew);
+
+        if (index->isUpToDate)
+            return index->files;
+
+        //listed here, so the index thread doesn't need to
+        index->needsScan = false;
+        generation = index->generation;
+    }
+
+    if (isNew)
+        updateWatchedDirectories();
+
+    Array<File> files;
+
+    for (const auto& entry : RangedDirectoryIterator (directory, false, wildcard, whatToLookFor))
+        files.add (entry.getFile());
+
+    files.sort();
+    addResults (index, generation, files, true);
+    return files;
+}
+
+//==============================================================================
+CabbageDirectoryIndex::Index* CabbageDirectoryIndex::findOrCreateIndex (const File& directory, const String& wildcard, int whatToLookFor, bool& isNew)
+{
+    for (auto* index : indexes)
+        if (index->directory == directory && index->wildcard == wildcard && index->whatToLookFor == whatToLookFor)
+            return index;
+
+    auto* index = indexes.add (new Index());
+    index->directory = directory;
+    index->wildcard = wildcard;
+    index->whatToLookFor = whatToLookFor;
+    isNew = true;
+    return index;
+}
+
+void CabbageDirectoryIndex::updateWatchedDirectories()
+{
+    Array<File> directories;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (auto* index : indexes)
+            directories.addIfNotAlreadyThere (index->directory);
+    }
+
+    fileWatcher->setWatchedFiles (this, directories);
+}
+
+void CabbageDirectoryIndex::watchedFilesChanged (const Array<File>& changedFiles)
+{
+    {
+        const ScopedLock sl (lock);
+
+        for (auto* index : indexes)
+        {
+            if (changedFiles.contains (index->directory))
+            {
+                ++index->generation;
+                index->isUpToDate = false;
+                index->needsScan = true;
+            }
+        }
+    }
+
+    //a directory that didn't exist before is watched differently once it does
+    updateWatchedDirectories();
+    notify();
+}
+
+//==============================================================================
+void CabbageDirectoryIndex::run()
+{
+    while (! threadShouldExit())
+    {
+        Index* index = nullptr;
+        File directory;
+        String wildcard;
+        int whatToLookFor = 0, generation = 0;
+
+        {
+            const ScopedLock sl (lock);
+
+            for (auto* i : indexes)
+            {
+                if (i->needsScan)
+                {
+                    index = i;
+                    break;
+                }
+            }
+
+            if (index != nullptr)
+            {
+                index->needsScan = false;
+                directory = index->directory;
+                wildcard = index->wildcard;
+                whatToLookFor = index->whatToLookFor;
+                generation = index->generation;
+            }
+        }
+
+        if (index == nullptr)
+        {
+            wait (-1);
+            continue;
+        }
+
+        scan (index, generation, directory, wildcard, whatToLookFor);
+    }
+}
+
+bool CabbageDirectoryIndex::scan (Index* index, int generation, const File& directory, const String& wildcard, int whatToLookFor)
+{
+    Array<File> files;
+
+    for (const auto& entry : RangedDirectoryIterator (directory, false, wildcard, whatToLookFor))
+    {
+        if (threadShouldExit())
+            return false;
+
+        files.add (entry.getFile());
+
+        if (files.size() % filesPerUpdate == 0)
+        {
+            Array<File> sortedFiles (files);
+            sortedFiles.sort();
+
+            //stop early if the directory has changed since this listing started
+            if (! addResults (index, generation, sortedFiles, false))
+                return false;
+        }
+    }
+
+    files.sort();
+    return addResults (index, generation, files, true);
+}
+
+bool CabbageDirectoryIndex::addResults (Index* index, int generation, const Array<File>& sortedFiles, bool isComplete)
+{
+    const ScopedLock sl (lock);
+
+    if (index->generation != generation)
+        return false;
+
+    //once a directory has been listed in full, partial listings would only make widgets flicker
+    if (! isComplete && index->hasBeenListed)
+        return true;
+
+    if (isComplete)
+    {
+        index->hasBeenListed = true;
+        index->isUpToDate = true;
+    }
+
+    if (sortedFiles != index->files)
+    {
+        index->files = sortedFiles;
+        index->hasNewResults = true;
+        triggerAsyncUpdate();
+    }
+
+    return true;
+}
+
+void CabbageDirectoryIndex::handleAsyncUpdate()
+{
+    Array<ListenerIndex> changedListeners;
+    Array<Array<File>> changedFiles;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (const auto& l : listeners)
+        {
+            if (l.index->hasNewResults)
+            {
+                changedListeners.add (l);
+                changedFiles.add (l.index->files);
+            }
+        }
+
+        for (auto* index : indexes)
+            index->hasNewResults = false;
+    }
+
+    for (int i = 0; i < changedListeners.size(); i++)
+    {
+        const auto& changed = changedListeners.getReference (i);
+
+        //an earlier listener may have removed this one, or moved it to another directory
+        bool isStillListening = false;
+
+        {
+            const ScopedLock sl (lock);
+
+            for (const auto& l : listeners)
+                isStillListening = isStillListening || (l.listener == changed.listener && l.index == changed.index);
+        }
+
+        if (isStillListening)
+            changed.listener->directoryIndexChanged (changedFiles.getReference (i));
+    }
+}
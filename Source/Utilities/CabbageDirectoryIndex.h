@@ -0,0 +1,103 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEDIRECTORYINDEX_H_INCLUDED
+#define CABBAGEDIRECTORYINDEX_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "CabbageFileWatcher.h"
+
+//==============================================================================
+// Directory listings for widgets that fill themselves from a folder, such as
+// comboboxes and listboxes with a filetype(). Every directory and wildcard
+// pair is listed once per process on the index's own thread and kept, so
+// reopening an editor or repopulating a widget doesn't touch the disk again.
+// The directories are watched through CabbageFileWatcher, and a listing is
+// only redone once files have been added or removed. The first listing of a
+// directory is handed over every filesPerUpdate files so large folders fill
+// in as they're read, later ones are only handed over once complete, and
+// only if something changed. The index is held through a
+// SharedResourcePointer and goes away with the last user.
+//==============================================================================
+class CabbageDirectoryIndex : private Thread, private AsyncUpdater, private CabbageFileWatcher::Listener
+{
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        //message thread, files are sorted the same way Array<File>::sort() does
+        virtual void directoryIndexChanged (const Array<File>& files) = 0;
+    };
+
+    static constexpr int filesPerUpdate = 500;
+
+    CabbageDirectoryIndex();
+    ~CabbageDirectoryIndex() override;
+
+    //message thread. A listener follows one directory at a time, this returns whatever is already known about it
+    Array<File> setDirectory (Listener* listener, const File& directory, const String& wildcard, int whatToLookFor);
+    void removeListener (Listener* listener);
+
+    //lists the listener's directory again even if nothing has been seen to change, the listener only hears back if it has
+    void rescan (Listener* listener);
+
+    //any thread, lists the directory on the calling thread if it isn't already known
+    Array<File> getFiles (const File& directory, const String& wildcard, int whatToLookFor);
+
+private:
+    struct Index
+    {
+        File directory;
+        String wildcard;
+        int whatToLookFor;
+        Array<File> files;
+        bool hasBeenListed = false;
+        bool isUpToDate = false;
+        bool needsScan = true;
+        bool hasNewResults = false;
+        int generation = 0;                 //bumped whenever a listing in progress goes out of date
+    };
+
+    struct ListenerIndex
+    {
+        Listener* listener;
+        Index* index;
+    };
+
+    void run() override;
+    void handleAsyncUpdate() override;
+    void watchedFilesChanged (const Array<File>& changedFiles) override;
+
+    Index* findOrCreateIndex (const File& directory, const String& wildcard, int whatToLookFor, bool& isNew);
+    void updateWatchedDirectories();
+    bool scan (Index* index, int generation, const File& directory, const String& wildcard, int whatToLookFor);
+    bool addResults (Index* index, int generation, const Array<File>& sortedFiles, bool isComplete);
+
+    SharedResourcePointer<CabbageFileWatcher> fileWatcher;
+
+    CriticalSection lock;
+    OwnedArray<Index> indexes;              //never removed, so an Index* stays valid while the index exists
+    Array<ListenerIndex> listeners;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageDirectoryIndex)
+};
+
+#endif  // CABBAGEDIRECTORYINDEX_H_INCLUDED
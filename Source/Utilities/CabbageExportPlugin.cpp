@@ -10,20 +10,61 @@
 
 #include "CabbageExportPlugin.h"
 #include <fstream>
+#include <map>
 
 //===============   methods for exporting plugins ==============================
-void PluginExporter::exportPlugin (String type, File csdFile, String pluginId, String destination, bool promptForFilename, bool encrypt)
+String PluginExporter::getPluginFileExtension (const String& type)
+{
+    const bool isMac = CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX;
+
+    if (type == "VCVRack")
+        return {};
+    if (type == "Unity" || type == "FMOD" || type == "FMODFx")
+        return isMac ? "bundle" : "dll";
+
+    if (CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::Linux)
+    {
+        if(type == "Standalone")
+            return {};
+        else
+            return "so";
+    }
+    else if (isMac)
+    {
+        if(type == "Standalone")
+            return "app";
+        else if(type.contains("VST3"))
+            return "vst3";
+        else if(type.contains("VST"))
+            return "vst";
+        else
+            return "component";
+    }
+    else
+    {
+        if(type == "Standalone")
+            return "exe";
+        else if(type.contains("VST3"))
+            return "vst3";
+        else
+            return "dll";
+    }
+}
+
+bool PluginExporter::exportPlugin (String type, File csdFile, String pluginId, String destination, bool promptForFilename, bool encrypt)
 {
     
     File outputFile;
+    bool succeeded = false;
+
     if(csdFile.hasFileExtension(".csd") == false)
-        return;
+        return false;
     
     
     if(csdFile.existsAsFile())
     {
         
-        String pluginFilename, fileExtension;
+        String pluginFilename, fileExtension = getPluginFileExtension (type);
         File thisFile = File::getSpecialLocation (File::currentApplicationFile);
 #if defined(JUCE_LINUX)	
         String currentApplicationDirectory = "/usr/bin";
@@ -31,36 +72,8 @@ void PluginExporter::exportPlugin (String type, File csdFile, String pluginId, S
         String currentApplicationDirectory = thisFile.getParentDirectory().getFullPathName();
 #endif
         
-        
-        if (CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::Linux)
-        {
-            if(type == "Standalone")
-                fileExtension = "";
-            else
-                fileExtension = "so";
-        }
-        else if (CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX)
-        {
-            if(type == "Standalone")
-                fileExtension = "app";
-            else if(type.contains("VST3"))
-                fileExtension = "vst3";
-            else if(type.contains("VST"))
-                fileExtension = "vst";
-            else
-                fileExtension = "component";
-            
+        if (CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX)
             currentApplicationDirectory = thisFile.getFullPathName() + "/Contents";
-        }
-        else
-        {
-            if(type == "Standalone")
-                fileExtension = "exe";
-            else if(type.contains("VST3"))
-                fileExtension = "vst3";
-            else
-                fileExtension = "dll";
-        }
         
 // #if CabbagePro && JUCE_MAC
 //         const String pluginDesc = String(JucePlugin_Manufacturer);
@@ -87,24 +100,20 @@ void PluginExporter::exportPlugin (String type, File csdFile, String pluginId, S
             pluginFilename = currentApplicationDirectory + String ("/"+pluginDesc.replace(" ", "_")+"EffectLV2." + fileExtension);
         else if (type == "VCVRack")
         {
-            fileExtension = "";
             pluginFilename = currentApplicationDirectory+"/CabbageRack/";
             if(!File(pluginFilename).exists())
                 pluginFilename = File::getSpecialLocation (File::currentApplicationFile).getParentDirectory().getFullPathName()+"/CabbageRack/";
         }
 		else if (type == "Unity")
 		{
-			fileExtension = ((CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX) ? String("bundle") : String("dll"));
 			pluginFilename = currentApplicationDirectory + ((CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX) ? String("/AudioPluginDemo.bundle") : String("/AudioPluginDemo.dll"));
 		}
         else if (type == "FMOD")
         {
-            fileExtension = ((CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX) ? String("bundle") : String("dll"));
             pluginFilename = currentApplicationDirectory + ((CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX) ? String("/fmod_csound.dylib") : String("/fmod_csound64.dll"));
         }
         else if (type == "FMODFx")
         {
-            fileExtension = ((CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX) ? String("bundle") : String("dll"));
             pluginFilename = currentApplicationDirectory + ((CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX) ? String("/fmod_csound_fx.dylib") : String("/fmod_csound64_fx.dll"));
             
         }
@@ -124,27 +133,29 @@ void PluginExporter::exportPlugin (String type, File csdFile, String pluginId, S
         
         if (!VSTData.exists())
         {
-            CabbageUtilities::showMessage("Error", pluginFilename + " cannot be found? It should be in the Cabbage root folder", &lookAndFeel);
-            return;
+            showError("Error", pluginFilename + " cannot be found? It should be in the Cabbage root folder");
+            return false;
         }
         
         //if batch converting plugins
         if(File(destination).exists())
         {
             const String newFile = File(destination).getChildFile(csdFile.getFileName()).getFullPathName();
-            writePluginFileToDisk(newFile, csdFile, VSTData, fileExtension, pluginId, type,
-                                  encrypt);
+            succeeded = writePluginFileToDisk(newFile, csdFile, VSTData, fileExtension, pluginId, type,
+                                              encrypt);
         }
         else if(promptForFilename == false)
         {
             String newFile = destination+"/"+csdFile.getFileNameWithoutExtension();
 
-            writePluginFileToDisk(newFile, csdFile, VSTData, fileExtension, pluginId, type,
-                                  encrypt);
+            succeeded = writePluginFileToDisk(newFile, csdFile, VSTData, fileExtension, pluginId, type,
+                                              encrypt);
             
         }
         else
         {
+            //the export finishes once the user has picked a file
+            succeeded = true;
             
             fileBrowser = std::make_unique<FileChooser>("Save file as..", csdFile.getParentDirectory().getFullPathName(), "*." + fileExtension, CabbageUtilities::shouldUseNativeBrowser());
             
@@ -211,11 +222,11 @@ void PluginExporter::exportPlugin (String type, File csdFile, String pluginId, S
         }
     }
     
-    
+    return succeeded;
 }
 
 
-void PluginExporter::writePluginFileToDisk(File fc, File csdFile, File VSTData, String fileExtension, String pluginId, String type, bool encrypt)
+bool PluginExporter::writePluginFileToDisk(File fc, File csdFile, File VSTData, String fileExtension, String pluginId, String type, bool encrypt)
 {
 
     //#if !CLIConverter
@@ -229,7 +240,10 @@ void PluginExporter::writePluginFileToDisk(File fc, File csdFile, File VSTData,
     if (type == "VCVRack")
     {
         if (!VSTData.copyDirectoryTo(exportedPlugin))
-            jassertfalse;
+        {
+            showError ("Error", "Exporting: " + csdFile.getFullPathName() + ", Can't copy " + VSTData.getFullPathName() + " to " + exportedPlugin.getFullPathName());
+            return false;
+        }
         File rackCsdFile(exportedPlugin.getFullPathName() + "/" + exportedPlugin.getFileName() + ".csd");
         //csdFile.moveFileTo(rackCsdFile);
         rackCsdFile.replaceWithText(csdFile.loadFileAsString());
@@ -256,7 +270,7 @@ void PluginExporter::writePluginFileToDisk(File fc, File csdFile, File VSTData,
 
         jsonFile.replaceWithText(jsonLines.joinIntoString("\n"));
 
-        return;
+        return true;
     }
 
     //plugin files on OSX are bundles, so we need to recursively delete all files in bundle
@@ -277,28 +291,36 @@ void PluginExporter::writePluginFileToDisk(File fc, File csdFile, File VSTData,
     system(mkdir.c_str());
 
 #if JUCE_WINDOWS
+    bool copied;
     if (VSTData.isDirectory())
-        VSTData.copyDirectoryTo(exportedPlugin);
+        copied = VSTData.copyDirectoryTo(exportedPlugin);
     else
-        VSTData.copyFileTo(exportedPlugin);
+        copied = VSTData.copyFileTo(exportedPlugin);
 #else
 
     auto command = "cp -Rf " + VSTData.getFullPathName().toStdString() + " " +exportedPlugin.getFullPathName().toStdString();
-    system(command.c_str());
+    const bool copied = system(command.c_str()) == 0;
 #endif
+
+    if (!copied)
+    {
+        showError ("Error", "Exporting: " + csdFile.getFullPathName() + ", Can't copy plugin to " + exportedPlugin.getFullPathName());
+        return false;
+    }
 #else
     if (!VSTData.copyFileTo (exportedPlugin))
     {
 
         Logger::writeToLog("Could not create plugin file. Check write access");
 
-        CabbageUtilities::showMessage ("Error", "Exporting: " + csdFile.getFullPathName() + ", Can't copy plugin to this location. It currently be in use, or you may be trying to install to a system folder you don't have permission to write in. Please try exporting to a different location.", &lookAndFeel);
+        showError ("Error", "Exporting: " + csdFile.getFullPathName() + ", Can't copy plugin to this location. It currently be in use, or you may be trying to install to a system folder you don't have permission to write in. Please try exporting to a different location.");
 
-        return;
+        return false;
     }
 #endif
     
     File exportedCsdFile;
+    bool succeeded = true;
     
     
     if (CabbageUtilities::getTargetPlatform() == CabbageUtilities::TargetPlatformTypes::OSX)
@@ -338,7 +360,7 @@ void PluginExporter::writePluginFileToDisk(File fc, File csdFile, File VSTData,
             else
                   bin = File(exportedPlugin.getFullPathName() + String ("/Contents/MacOS/"+pluginDesc));
             
-            setUniquePluginId (bin, exportedCsdFile, pluginId);
+            setUniquePluginId (bin, exportedCsdFile, pluginId, VSTData.getChildFile (bin.getRelativePathFrom (exportedPlugin)));
             
             File pl (exportedPlugin.getFullPathName() + String ("/Contents/Info.plist"));
             String newPList = pl.loadFileAsString();
@@ -349,7 +371,10 @@ void PluginExporter::writePluginFileToDisk(File fc, File csdFile, File VSTData,
                 File pluginBinary (exportedPlugin.getFullPathName() + String ("/Contents/MacOS/") + fc.getFileNameWithoutExtension());
 
                 if (bin.moveFileTo (pluginBinary) == false)
-                    CabbageUtilities::showMessage ("Error", "Could not copy library binary file. Make sure the two Cabbage .vst files are located in the Cabbage.app folder", &lookAndFeel);
+                {
+                    showError ("Error", "Could not copy library binary file. Make sure the two Cabbage .vst files are located in the Cabbage.app folder");
+                    succeeded = false;
+                }
 
 #if CabbagePro
                 newPList = newPList.replace (pluginDesc+"Effect", fc.getFileNameWithoutExtension());
@@ -389,7 +414,7 @@ void PluginExporter::writePluginFileToDisk(File fc, File csdFile, File VSTData,
             newPList = newPList.replace (toReplace, pluginName);
             if(pluginId.isEmpty())
             {
-                CabbageUtilities::showMessage ("Error", "The plugin ID identifier in " + csdFile.getFullPathName() + " is empty, or the pluginid identifier string contains a typo. Certain hosts may not recognise your plugin. Please use a unique ID for each plugin.", &lookAndFeel);
+                showError ("Error", "The plugin ID identifier in " + csdFile.getFullPathName() + " is empty, or the pluginid identifier string contains a typo. Certain hosts may not recognise your plugin. Please use a unique ID for each plugin.");
                 pluginId = "Cab2";
             }
             
@@ -415,60 +440,179 @@ void PluginExporter::writePluginFileToDisk(File fc, File csdFile, File VSTData,
         else
             exportedCsdFile.replaceWithText (csdFile.loadFileAsString());
 
-        setUniquePluginId(exportedPlugin, exportedCsdFile, pluginId);
+        setUniquePluginId(exportedPlugin, exportedCsdFile, pluginId, VSTData);
         addFilesToPluginBundle(csdFile, exportedPlugin);
     }
-            
+
+    return succeeded;
 }
 
 //==============================================================================
-// Set unique plugin ID for each plugin based on the file name
+// Set unique plugin ID for each plugin based on the file name. The exported
+// binary is a straight copy of the template it was made from, so the ID is
+// written at the offsets found in the template, and only those bytes of the
+// copy are touched. If the copy doesn't hold a placeholder at each of those
+// offsets, the cached offsets are stale and the copy is searched instead.
 //==============================================================================
-int PluginExporter::setUniquePluginId (File binFile, File csdFile, String pluginId)
+int PluginExporter::setUniquePluginId (File binFile, File csdFile, String pluginId, File templateFile)
 {
-    size_t file_size;
-    //both mac and Windows encode the plugin IDs differently, so we run through a loop of both possibilities..
-    const char* pluginIDToReplace[] = { "RORY", "YROR" };
-    
-    long loc;
-    std::fstream mFile (binFile.getFullPathName().toUTF8(), std::ios_base::in | std::ios_base::out | std::ios_base::binary);
-    
-    for(int i = 0 ; i < 2 ; i++)
+    if (! templateFile.existsAsFile() || templateFile.getSize() != binFile.getSize())
+        templateFile = binFile;
+
+    Array<int64> offsets = getPluginIdOffsets (templateFile);
+
+    if (! hasPluginIdPlaceholders (binFile, offsets))
+    {
+        forgetPluginIdOffsets (templateFile);
+        offsets = findPluginIdOffsets (binFile);
+    }
+
+    FileOutputStream stream (binFile);
+
+    if (stream.failedToOpen())
+    {
+        DBG ("===============================\nError/n=======================================\n" + csdFile.getFullPathName()+" File could not be opened");
+        return 1;
+    }
+
+    char id[4] = {};
+    memcpy (id, pluginId.toRawUTF8(), (size_t) jmin (4, (int) pluginId.getNumBytesAsUTF8()));
+
+    for (const auto offset : offsets)
+    {
+        stream.setPosition (offset);
+        stream.write (id, 4);
+    }
+
+    return 1;
+}
+
+//==============================================================================
+// Offsets of the placeholder plugin IDs in a template binary. The offsets are
+// kept in memory and in a file in the temp directory, so each version of a
+// template is only searched once.
+//==============================================================================
+struct PluginIdOffsetCache
+{
+    struct TemplateOffsets
+    {
+        Time lastModified;
+        int64 size;
+        Array<int64> offsets;
+    };
+
+    static File getSidecarFile (const File& templateFile)
+    {
+        return File::getSpecialLocation (File::tempDirectory).getChildFile ("CabbagePluginIdOffsets")
+                   .getChildFile (String::toHexString (templateFile.getFullPathName().hashCode64()) + ".txt");
+    }
+
+    CriticalSection lock;
+    std::map<String, TemplateOffsets> templates;
+};
+
+static PluginIdOffsetCache pluginIdOffsetCache;
+
+Array<int64> PluginExporter::getPluginIdOffsets (const File& templateFile)
+{
+    const ScopedLock sl (pluginIdOffsetCache.lock);
+    const Time lastModified = templateFile.getLastModificationTime();
+    const int64 size = templateFile.getSize();
+    auto& cached = pluginIdOffsetCache.templates[templateFile.getFullPathName()];
+
+    if (cached.lastModified == lastModified && cached.size == size)
+        return cached.offsets;
+
+    cached = { lastModified, size, {} };
+
+    //the first line records which version of the template the offsets belong to
+    const String version = String (size) + " " + String (lastModified.toMilliseconds());
+    const File sidecar = PluginIdOffsetCache::getSidecarFile (templateFile);
+    StringArray lines;
+    lines.addLines (sidecar.loadFileAsString());
+
+    if (lines.size() > 0 && lines[0] == version)
     {
-        if (mFile.is_open())
+        for (int i = 1; i < lines.size(); i++)
+            if (lines[i].isNotEmpty())
+                cached.offsets.add (lines[i].getLargeIntValue());
+
+        return cached.offsets;
+    }
+
+    cached.offsets = findPluginIdOffsets (templateFile);
+
+    lines.clearQuick();
+    lines.add (version);
+    for (const auto offset : cached.offsets)
+        lines.add (String (offset));
+
+    sidecar.getParentDirectory().createDirectory();
+    sidecar.replaceWithText (lines.joinIntoString ("\n"));
+    return cached.offsets;
+}
+
+void PluginExporter::forgetPluginIdOffsets (const File& templateFile)
+{
+    const ScopedLock sl (pluginIdOffsetCache.lock);
+    pluginIdOffsetCache.templates.erase (templateFile.getFullPathName());
+    PluginIdOffsetCache::getSidecarFile (templateFile).deleteFile();
+}
+
+//==============================================================================
+// Mac and Windows encode the IDs differently, so both byte orders are looked
+// for, up to ten of each. The binary is memory mapped and searched in a
+// single pass.
+//==============================================================================
+Array<int64> PluginExporter::findPluginIdOffsets (const File& binaryFile)
+{
+    Array<int64> offsets;
+    MemoryMappedFile mappedFile (binaryFile, MemoryMappedFile::readOnly);
+    const auto* data = static_cast<const char*> (mappedFile.getData());
+    const int64 numBytes = (int64) mappedFile.getSize();
+    const char* placeholders[] = { "RORY", "YROR" };
+    int numFound[] = { 0, 0 };
+
+    for (int64 i = 0; data != nullptr && i + 4 <= numBytes; i++)
+    {
+        if (data[i] != 'R' && data[i] != 'Y')
+            continue;
+
+        for (int p = 0; p < 2; p++)
         {
-            mFile.seekg (0, std::ios::end);
-            file_size = mFile.tellg();
-            unsigned char* buffer = (unsigned char*)malloc (sizeof (unsigned char) * file_size);
-            
-            //set plugin ID, do this a few times in case the plugin ID appear in more than one place.
-            for (int r = 0; r < 10; r++)
+            if (numFound[p] < 10 && memcmp (data + i, placeholders[p], 4) == 0)
             {
-                mFile.seekg (0, std::ios::beg);
-                mFile.read ((char*)&buffer[0], file_size);
-                loc = cabbageFindPluginId (buffer, file_size, pluginIDToReplace[i]);
-                
-                if (loc < 0)
-                {
-                    break;
-                }
-                else
-                {
-                    mFile.seekg (loc, std::ios::beg);
-                    mFile.write (pluginId.toUTF8(), 4);
-                }
+                offsets.add (i);
+                ++numFound[p];
             }
-            
-            free (buffer);
-            
         }
-        else
-            DBG ("===============================\nError/n=======================================\n" + csdFile.getFullPathName()+" File could not be opened");
+
+        if (numFound[0] == 10 && numFound[1] == 10)
+            break;
     }
-    mFile.close();
-    
-    return 1;
+
+    return offsets;
 }
+
+bool PluginExporter::hasPluginIdPlaceholders (const File& binaryFile, const Array<int64>& offsets)
+{
+    FileInputStream stream (binaryFile);
+
+    if (stream.failedToOpen())
+        return false;
+
+    for (const auto offset : offsets)
+    {
+        char bytes[4] = {};
+
+        if (! stream.setPosition (offset) || stream.read (bytes, 4) != 4
+            || (memcmp (bytes, "RORY", 4) != 0 && memcmp (bytes, "YROR", 4) != 0))
+            return false;
+    }
+
+    return true;
+}
+
 //==============================================================================
 // Bundles files with VST
 //==============================================================================
@@ -488,7 +632,7 @@ void PluginExporter::addFilesToPluginBundle (File csdFile, File exportDir)
             
             if (includeFile.exists())
             {
-                includeFile.copyFileTo(newFile);
+                copyIfChanged(includeFile, newFile);
             }
             else
             {
@@ -497,9 +641,8 @@ void PluginExporter::addFilesToPluginBundle (File csdFile, File exportDir)
         }
         
         if (invalidFiles.size() > 0)
-            CabbageUtilities::showMessage(
-                                          "Cabbage could not bundle the following files\n" + invalidFiles.joinIntoString("\n") +
-                                          "\nPlease make sure they are located in the same folder as your .csd file.", &lookAndFeel);
+            showError("", "Cabbage could not bundle the following files\n" + invalidFiles.joinIntoString("\n") +
+                      "\nPlease make sure they are located in the same folder as your .csd file.");
     }
     
     StringArray linesFromCsd;
@@ -521,10 +664,8 @@ void PluginExporter::addFilesToPluginBundle (File csdFile, File exportDir)
                     const File bundleFile = csdFile.getParentDirectory().getChildFile (bundleFiles[i].toString());
                     File newFile(exportDir.getParentDirectory().getFullPathName() + "/" + bundleFiles[i].toString());
                     
-                    if (bundleFile.existsAsFile())
-                        bundleFile.copyFileTo(newFile);
-                    else if(bundleFile.exists())
-                        bundleFile.copyDirectoryTo(newFile);
+                    if (bundleFile.exists())
+                        copyIfChanged(bundleFile, newFile);
                     else
                     {
                         invalidFiles.add(csdFile.getParentDirectory().getChildFile (bundleFiles[i].toString()).getFullPathName());
@@ -534,42 +675,78 @@ void PluginExporter::addFilesToPluginBundle (File csdFile, File exportDir)
     }
     
     if (invalidFiles.size() > 0)
-        CabbageUtilities::showMessage(
-                                      "Cabbage could not bundle the following files\n" + invalidFiles.joinIntoString("\n") +
-                                      "\nPlease make sure they are located in the same folder as your .csd file.", &lookAndFeel);
+        showError("", "Cabbage could not bundle the following files\n" + invalidFiles.joinIntoString("\n") +
+                  "\nPlease make sure they are located in the same folder as your .csd file.");
     
 }
 
 
+//==============================================================================
+// Bundled files are often shared by a lot of plugins, sample sets for example,
+// so copies are skipped when the destination already has the same content.
+// Each source file is only hashed once per process unless it changes.
+//==============================================================================
+bool PluginExporter::copyIfChanged (const File& source, const File& destination)
+{
+    if (source.isDirectory())
+    {
+        bool ok = destination.createDirectory().wasOk();
+
+        for (const auto& entry : RangedDirectoryIterator (source, false, "*", File::findFilesAndDirectories))
+            ok = copyIfChanged (entry.getFile(), destination.getChildFile (entry.getFile().getFileName())) && ok;
+
+        return ok;
+    }
+
+    //batch exports of the same csd in different formats bundle into the same folder from different threads,
+    //so copies to a given destination are serialised, the later ones then find the content already there
+    static CriticalSection destinationLocks[64];
+    const ScopedLock sl (destinationLocks[(uint64) destination.getFullPathName().hashCode64() % 64]);
+
+    if (destination.existsAsFile() && destination.getSize() == source.getSize()
+        && MD5 (destination) == getContentHash (source))
+        return true;
 
-long PluginExporter::cabbageFindPluginId (unsigned char* buf, size_t len, const char* s)
+    return source.copyFileTo (destination);
+}
+
+MD5 PluginExporter::getContentHash (const File& file)
 {
-    long i, j;
-    size_t slen = strlen (s);
-    size_t imax = len - slen - 1;
-    long ret = -1;
-    int match;
-    
-    for (i = 0; i < imax; i++)
+    struct HashedFile
     {
-        match = 1;
-        
-        for (j = 0; j < slen; j++)
-        {
-            if (buf[i + j] != s[j])
-            {
-                match = 0;
-                break;
-            }
-        }
-        
-        if (match)
-        {
-            ret = i;
-            break;
-        }
+        Time lastModified;
+        int64 size;
+        MD5 hash;
+    };
+
+    static CriticalSection lock;
+    static std::map<String, HashedFile> hashedFiles;
+
+    const Time lastModified = file.getLastModificationTime();
+    const int64 size = file.getSize();
+
+    {
+        const ScopedLock sl (lock);
+        const auto it = hashedFiles.find (file.getFullPathName());
+
+        if (it != hashedFiles.end() && it->second.lastModified == lastModified && it->second.size == size)
+            return it->second.hash;
     }
-    
-    //return position of plugin ID
-    return ret;
+
+    const MD5 hash (file);
+    const ScopedLock sl (lock);
+    hashedFiles[file.getFullPathName()] = { lastModified, size, hash };
+    return hash;
+}
+
+void PluginExporter::showError (const String& title, const String& message)
+{
+#if CLIConverter
+    //the converter has no windows, and can be exporting from several threads at once
+    static CriticalSection outputLock;
+    const ScopedLock sl (outputLock);
+    std::cerr << (title.isEmpty() ? "Cabbage Message" : title) << ": " << message << std::endl;
+#else
+    CabbageUtilities::showMessage (title.isEmpty() ? "Cabbage Message" : title, message, &lookAndFeel);
+#endif
 }
@@ -35,13 +35,26 @@ public:
     PluginExporter():lookAndFeel(), settings(nullptr){}
     void settingsToUse(PropertiesFile* cabSettings){   settings = cabSettings; }
 
-    long cabbageFindPluginId (unsigned char* buf, size_t len, const char* s);
-    int setUniquePluginId (File binFile, File csdFile, String pluginId);
-    void writePluginFileToDisk (File fc, File csdFile, File VSTData, String fileExtension, String pluginId, String type, bool encrypt = false);
+    int setUniquePluginId (File binFile, File csdFile, String pluginId, File templateFile = {});
+    static Array<int64> getPluginIdOffsets (const File& templateFile);
+    static void forgetPluginIdOffsets (const File& templateFile);
+    static Array<int64> findPluginIdOffsets (const File& binaryFile);
+    static bool hasPluginIdPlaceholders (const File& binaryFile, const Array<int64>& offsets);
+    bool writePluginFileToDisk (File fc, File csdFile, File VSTData, String fileExtension, String pluginId, String type, bool encrypt = false);
     void addFilesToPluginBundle (File csdFile, File exportDir);
-    void exportPlugin (String type, File csdFile, String pluginId, String destination="", bool promptForFilename = true, bool encrypt = false);
+    //returns false if the plugin couldn't be written, when prompting for a filename that happens later and this returns true
+    bool exportPlugin (String type, File csdFile, String pluginId, String destination="", bool promptForFilename = true, bool encrypt = false);
+    //extension of the exported plugin for a type such as "VST3i", empty for types that export a directory
+    static String getPluginFileExtension (const String& type);
 
     bool adhocSign = false;
+
+    //copies a file or directory, skipping any file whose destination already has the same content
+    static bool copyIfChanged (const File& source, const File& destination);
+    static MD5 getContentHash (const File& file);
+
+    //shows an alert in the IDE, the command line converter prints it instead
+    void showError (const String& title, const String& message);
     
     
     String encodeString (File csdFile)
@@ -97,8 +110,7 @@ public:
         
         if(headerDefs.size() < 3)
         {
-            CabbageUtilities::showMessage(
-                                          "Please make sure that your orc header section contains assignments for ksmps, nchnls and 0dbfs.", &lookAndFeel);
+            showError("", "Please make sure that your orc header section contains assignments for ksmps, nchnls and 0dbfs.");
             return "";
         }
         //grab orc / and sco and encrypt..
@@ -0,0 +1,398 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CabbageFileWatcher.h"
+
+#if JUCE_LINUX
+ #include <sys/inotify.h>
+ #include <poll.h>
+ #include <unistd.h>
+ #include <fcntl.h>
+#endif
+
+//==============================================================================
+CabbageFileWatcher::CabbageFileWatcher() : Thread ("Cabbage file watcher")
+{
+   #if JUCE_LINUX
+    inotifyFd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+
+    if (inotifyFd >= 0 && pipe2 (wakeUpPipe, O_NONBLOCK | O_CLOEXEC) != 0)
+    {
+        close (inotifyFd);
+        inotifyFd = -1;
+    }
+   #endif
+
+    startThread (1);
+}
+
+CabbageFileWatcher::~CabbageFileWatcher()
+{
+    signalThreadShouldExit();
+    wakeUp();
+    stopThread (2000);
+    cancelPendingUpdate();
+
+   #if JUCE_LINUX
+    if (inotifyFd >= 0)
+    {
+        close (inotifyFd);
+        close (wakeUpPipe[0]);
+        close (wakeUpPipe[1]);
+    }
+   #endif
+}
+
+//==============================================================================
+void CabbageFileWatcher::setWatchedFiles (Listener* listener, const Array<File>& files)
+{
+    if (files.isEmpty())
+    {
+        removeListener (listener);
+        return;
+    }
+
+    {
+        const ScopedLock sl (lock);
+        bool found = false;
+
+        for (auto& watch : watches)
+        {
+            if (watch.listener == listener)
+            {
+                watch.files = files;
+                found = true;
+            }
+        }
+
+        if (! found)
+            watches.add ({ listener, files });
+
+        watchesChanged = true;
+    }
+
+    wakeUp();
+}
+
+void CabbageFileWatcher::removeListener (Listener* listener)
+{
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = watches.size(); --i >= 0;)
+        {
+            if (watches.getReference (i).listener == listener)
+            {
+                watches.remove (i);
+                watchesChanged = true;
+            }
+        }
+    }
+
+    wakeUp();
+}
+
+void CabbageFileWatcher::addFileAndIncludes (const File& file, Array<File>& files)
+{
+    if (files.contains (file))
+        return;
+
+    //files that don't exist yet are watched too, so creating one is noticed
+    files.add (file);
+
+    if (! file.existsAsFile())
+        return;
+
+    StringArray lines;
+    lines.addLines (file.loadFileAsString());
+
+    for (const auto& line : lines)
+    {
+        const String trimmed = line.trimStart();
+
+        if (! trimmed.startsWith ("#include") || trimmed.startsWith ("#includestr"))
+            continue;
+
+        //Csound accepts any character as the delimiter around the file name
+        const String rest = trimmed.substring (8).trimStart();
+
+        if (rest.isEmpty())
+            continue;
+
+        const int end = rest.indexOfChar (1, rest[0]);
+
+        if (end > 1)
+            addFileAndIncludes (file.getParentDirectory().getChildFile (rest.substring (1, end)), files);
+    }
+}
+
+//==============================================================================
+void CabbageFileWatcher::run()
+{
+    uint32 lastPollTime = 0;
+
+    while (! threadShouldExit())
+    {
+        bool shouldUpdateWatchedFiles;
+
+        {
+            const ScopedLock sl (lock);
+            shouldUpdateWatchedFiles = watchesChanged;
+            watchesChanged = false;
+        }
+
+        if (shouldUpdateWatchedFiles)
+            updateWatchedFiles();
+
+        const uint32 now = Time::getMillisecondCounter();
+
+        if (! polledFiles.isEmpty() && now - lastPollTime >= (uint32) pollIntervalMs)
+        {
+            pollModificationTimes();
+            lastPollTime = now;
+        }
+
+        if (! pendingChanges.isEmpty() && now - lastChangeTime >= (uint32) debounceMs)
+        {
+            {
+                const ScopedLock sl (lock);
+
+                for (const auto& file : pendingChanges)
+                    readyChanges.addIfNotAlreadyThere (file);
+            }
+
+            pendingChanges.clear();
+            triggerAsyncUpdate();
+        }
+
+        //sleep until something happens, or until the next poll or the end of a burst of writes
+        int timeoutMs = -1;
+
+        if (! polledFiles.isEmpty())
+            timeoutMs = pollIntervalMs;
+
+        if (! pendingChanges.isEmpty())
+            timeoutMs = debounceMs;
+
+        waitForEvents (timeoutMs);
+    }
+}
+
+void CabbageFileWatcher::updateWatchedFiles()
+{
+    Array<File> files;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (const auto& watch : watches)
+            for (const auto& file : watch.files)
+                files.addIfNotAlreadyThere (file);
+    }
+
+    watchedPaths.clear();
+    polledFiles.clear();
+
+    for (const auto& file : files)
+        watchedPaths.set (file.getFullPathName(), true);
+
+   #if JUCE_LINUX
+    if (inotifyFd >= 0)
+    {
+        HashMap<String, bool> directoriesNeeded;
+
+        for (const auto& file : files)
+        {
+            //a directory is watched itself, a file through the directory it lives in
+            const String directory = (file.isDirectory() ? file : file.getParentDirectory()).getFullPathName();
+
+            if (! directoryWatches.contains (directory))
+            {
+                const int wd = inotify_add_watch (inotifyFd, directory.toRawUTF8(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE);
+
+                if (wd < 0)
+                {
+                    polledFiles.add (file);
+                    continue;
+                }
+
+                directoryWatches.set (directory, wd);
+                watchedDirectories.set (wd, directory);
+            }
+
+            directoriesNeeded.set (directory, true);
+        }
+
+        StringArray unusedDirectories;
+
+        for (HashMap<String, int>::Iterator i (directoryWatches); i.next();)
+            if (! directoriesNeeded.contains (i.getKey()))
+                unusedDirectories.add (i.getKey());
+
+        for (const auto& directory : unusedDirectories)
+        {
+            const int wd = directoryWatches[directory];
+            inotify_rm_watch (inotifyFd, wd);
+            watchedDirectories.remove (wd);
+            directoryWatches.remove (directory);
+        }
+    }
+    else
+   #endif
+    {
+        polledFiles = files;
+    }
+
+    //files that are new to the list start from their current state rather than counting as changed
+    HashMap<String, int64> times;
+
+    for (const auto& file : polledFiles)
+    {
+        const String path = file.getFullPathName();
+        times.set (path, modificationTimes.contains (path) ? modificationTimes[path] : file.getLastModificationTime().toMilliseconds());
+    }
+
+    modificationTimes.swapWith (times);
+}
+
+void CabbageFileWatcher::pollModificationTimes()
+{
+    for (const auto& file : polledFiles)
+    {
+        const String path = file.getFullPathName();
+        const int64 time = file.getLastModificationTime().toMilliseconds();
+
+        if (modificationTimes[path] != time)
+        {
+            modificationTimes.set (path, time);
+            addChange (file);
+        }
+    }
+}
+
+void CabbageFileWatcher::addChange (const File& file)
+{
+    pendingChanges.addIfNotAlreadyThere (file);
+    lastChangeTime = Time::getMillisecondCounter();
+}
+
+void CabbageFileWatcher::waitForEvents (int timeoutMs)
+{
+   #if JUCE_LINUX
+    if (inotifyFd >= 0)
+    {
+        pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { wakeUpPipe[0], POLLIN, 0 } };
+
+        if (::poll (fds, 2, timeoutMs) > 0)
+        {
+            if ((fds[0].revents & POLLIN) != 0)
+                readInotifyEvents();
+
+            char buffer[64];
+            while (read (wakeUpPipe[0], buffer, sizeof (buffer)) > 0) {}
+        }
+
+        return;
+    }
+   #endif
+
+    wait (timeoutMs);
+}
+
+void CabbageFileWatcher::wakeUp()
+{
+   #if JUCE_LINUX
+    if (inotifyFd >= 0)
+    {
+        const char byte = 0;
+        ignoreUnused (write (wakeUpPipe[1], &byte, 1));
+        return;
+    }
+   #endif
+
+    notify();
+}
+
+#if JUCE_LINUX
+void CabbageFileWatcher::readInotifyEvents()
+{
+    alignas (inotify_event) char buffer[4096];
+
+    for (ssize_t numBytes = read (inotifyFd, buffer, sizeof (buffer)); numBytes > 0; numBytes = read (inotifyFd, buffer, sizeof (buffer)))
+    {
+        for (char* p = buffer; p < buffer + numBytes;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*> (p);
+
+            if (event->len > 0 && watchedDirectories.contains (event->wd))
+            {
+                const String directory = watchedDirectories[event->wd];
+                const File file = File (directory).getChildFile (event->name);
+
+                if (watchedPaths.contains (file.getFullPathName()))
+                    addChange (file);
+
+                //a watched directory only cares about its listing, not about what's written to the files in it
+                if ((event->mask & IN_CLOSE_WRITE) == 0 && watchedPaths.contains (directory))
+                    addChange (File (directory));
+            }
+
+            p += sizeof (inotify_event) + event->len;
+        }
+    }
+}
+#endif
+
+//==============================================================================
+void CabbageFileWatcher::handleAsyncUpdate()
+{
+    Array<File> changes;
+    Array<Watch> currentWatches;
+
+    {
+        const ScopedLock sl (lock);
+        changes.swapWith (readyChanges);
+        currentWatches = watches;
+    }
+
+    for (const auto& watch : currentWatches)
+    {
+        Array<File> changedFiles;
+
+        for (const auto& file : changes)
+            if (watch.files.contains (file))
+                changedFiles.add (file);
+
+        if (changedFiles.isEmpty())
+            continue;
+
+        //an earlier listener may have removed this one while handling its own changes
+        bool isStillWatching = false;
+
+        {
+            const ScopedLock sl (lock);
+
+            for (const auto& w : watches)
+                isStillWatching = isStillWatching || w.listener == watch.listener;
+        }
+
+        if (isStillWatching)
+            watch.listener->watchedFilesChanged (changedFiles);
+    }
+}
@@ -0,0 +1,103 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEFILEWATCHER_H_INCLUDED
+#define CABBAGEFILEWATCHER_H_INCLUDED
+
+#include "JuceHeader.h"
+
+//==============================================================================
+// One watcher per process, shared by the IDE and every plugin instance
+// through a SharedResourcePointer. Each listener hands over the files it
+// depends on and is told when any of them change. On Linux the files'
+// directories are watched with inotify, so nothing runs until something is
+// written. Elsewhere, or if inotify isn't available, modification times are
+// checked on the watcher's own thread. Bursts of writes, such as an editor
+// saving through a temp file, are collected until things have been quiet
+// for debounceMs, then delivered on the message thread. Each listener only
+// hears about its own files. A directory can be watched like a file, in
+// which case files being added to it or removed from it count as changes to
+// the directory.
+//==============================================================================
+class CabbageFileWatcher : private Thread, private AsyncUpdater
+{
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        //message thread
+        virtual void watchedFilesChanged (const Array<File>& changedFiles) = 0;
+    };
+
+    static constexpr int debounceMs = 250;
+    static constexpr int pollIntervalMs = 1000;
+
+    CabbageFileWatcher();
+    ~CabbageFileWatcher() override;
+
+    //replaces whatever the listener was watching before, an empty array is the same as removeListener()
+    void setWatchedFiles (Listener* listener, const Array<File>& files);
+    void removeListener (Listener* listener);
+
+    //the file and anything it pulls in with #include, followed recursively
+    static void addFileAndIncludes (const File& file, Array<File>& files);
+
+private:
+    struct Watch
+    {
+        Listener* listener;
+        Array<File> files;
+    };
+
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    void updateWatchedFiles();
+    void pollModificationTimes();
+    void waitForEvents (int timeoutMs);
+    void wakeUp();
+    void addChange (const File& file);
+
+    CriticalSection lock;
+    Array<Watch> watches;
+    bool watchesChanged = false;
+    Array<File> readyChanges;                   //handed over to the message thread
+
+    //watch thread only
+    HashMap<String, bool> watchedPaths;
+    Array<File> polledFiles;                    //every file without inotify, otherwise only those whose directory couldn't be watched
+    HashMap<String, int64> modificationTimes;
+    Array<File> pendingChanges;
+    uint32 lastChangeTime = 0;
+
+   #if JUCE_LINUX
+    void readInotifyEvents();
+
+    int inotifyFd = -1;
+    int wakeUpPipe[2] = { -1, -1 };
+    HashMap<String, int> directoryWatches;      //directory path to watch descriptor
+    HashMap<int, String> watchedDirectories;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabbageFileWatcher)
+};
+
+#endif  // CABBAGEFILEWATCHER_H_INCLUDED
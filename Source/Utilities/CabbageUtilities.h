@@ -24,6 +24,7 @@
 
 #include "JuceHeader.h"
 #include "../BinaryData/CabbageBinaryData.h"
+#include "CabbageDirectoryIndex.h"
 
 #include <fstream>
 
@@ -1305,7 +1306,6 @@ public:
 
 	static void searchDirectoryForFiles(String workingDir, String fileType, Array<File> & folderFiles, StringArray &comboItems, int& numberOfFiles)
 	{
-		Array<File> dirFiles;
 		File pluginDir;
 
 		if (workingDir.isNotEmpty())
@@ -1313,17 +1313,10 @@ public:
 		else
 			pluginDir = File::getCurrentWorkingDirectory();
 
-		pluginDir.findChildFiles(dirFiles, 2, false, fileType);
-
-		for (int i = 0; i < dirFiles.size(); ++i)
-			folderFiles.add(dirFiles[i]);
-
-		folderFiles.sort();
-
-		for (int i = 0; i < folderFiles.size(); i++)
-		{
-			CabbageUtilities::debug(folderFiles[i].getFullPathName());
-		}
+		//only lists the directory if it hasn't been already, the listing comes back sorted. Widgets
+		//list files and directories, so asking for the same thing here shares their index entry
+		SharedResourcePointer<CabbageDirectoryIndex> directoryIndex;
+		folderFiles.addArray(directoryIndex->getFiles(pluginDir, fileType, File::findFilesAndDirectories));
 
 		for (int i = 0; i < folderFiles.size(); i++)
 		{
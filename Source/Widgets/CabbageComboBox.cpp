@@ -80,38 +80,19 @@ CabbageComboBox::CabbageComboBox (ValueTree wData, CabbagePluginEditor* _owner)
         workingDir = CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::currentdir);
         workingDir = CabbageUtilities::expandDirectoryMacro(workingDir);
         
-        int index = 0;
         if (workingDir.isNotEmpty())
             pluginDir = File(getCsdFile()).getParentDirectory().getChildFile (workingDir);
         else
             pluginDir = File(getCsdFile()).getParentDirectory();
         
         if(pluginDir.getChildFile(currentValueAsText).existsAsFile())
-        {
             currentValueAsText = pluginDir.getChildFile(currentValueAsText).getFileNameWithoutExtension();
-            index = stringItems.indexOf (currentValueAsText);
-        }
-        else
-        {
-            index = stringItems.indexOf (currentValueAsText);
-        }
-        
-        //this index if different for strings and files?
-        if (index >= 0)
-            setSelectedItemIndex (index, dontSendNotification);
-        else
-            setSelectedItemIndex (0, dontSendNotification);
-        
 
-        if (currentValueAsText.containsOnly("0123456789.-"))
-        {
-            index = currentValueAsText.getIntValue();
-        }
-
-        if(CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::filetype).isNotEmpty())
-            owner->sendChannelStringDataToCsound(getChannel(), folderFiles[index].getFileNameWithoutExtension());
+        //a directory the index hasn't listed yet fills in later, the selection is sent from addFileItems() then
+        if (CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::filetype).isNotEmpty() && folderFiles.isEmpty())
+            selectionPending = true;
         else
-            owner->sendChannelStringDataToCsound(getChannel(), stringItems[index]);
+            selectStringItem();
     }
     else
     {
@@ -139,7 +120,11 @@ CabbageComboBox::CabbageComboBox (ValueTree wData, CabbagePluginEditor* _owner)
         {
  
             owner->sendChannelDataToCsound (getChannel(), getValue());
-            setSelectedItemIndex (getValue() - 1, dontSendNotification);
+
+            if (CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::filetype).isNotEmpty() && folderFiles.isEmpty())
+                selectionPending = true;
+            else
+                setSelectedItemIndex (getValue() - 1, dontSendNotification);
         }
     }
 
@@ -149,6 +134,7 @@ CabbageComboBox::CabbageComboBox (ValueTree wData, CabbagePluginEditor* _owner)
 //---------------------------------------------
 CabbageComboBox::~CabbageComboBox()
 {
+    directoryIndex->removeListener (this);
     setLookAndFeel(nullptr);
     widgetData.removeListener(this);
 }
@@ -187,9 +173,9 @@ void CabbageComboBox::addItemsToCombobox (ValueTree wData)
         return;
     }
     
-    Array<File> dirFiles;
     presets.clear();
     folderFiles.clear();
+    directoryIndex->removeListener (this);
 
     //load items from text file
     if (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::file).isNotEmpty())
@@ -336,40 +322,78 @@ void CabbageComboBox::addItemsToCombobox (ValueTree wData)
             pluginDir = File(getCsdFile()).getParentDirectory();
 
         filetype = CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::filetype);
-        pluginDir.findChildFiles (dirFiles, File::TypesOfFileToFind::findFilesAndDirectories, false, filetype);
-        //addItem ("Select..", 1);
-        StringArray tempStrings;
-        for (int i = 0; i < dirFiles.size(); ++i){
-            folderFiles.add (dirFiles[i]);
-            tempStrings.add(dirFiles[i].getFileNameWithoutExtension());
-        }
+        //the directory is listed on the index's thread, anything not known yet turns up in directoryIndexChanged()
+        addFileItems (directoryIndex->setDirectory (this, pluginDir, filetype, File::TypesOfFileToFind::findFilesAndDirectories));
+    }
 
-        folderFiles.sort();
-        
-        if(stringItems == tempStrings)
-            return;
+}
+
+void CabbageComboBox::directoryIndexChanged (const Array<File>& files)
+{
+    addFileItems (files);
+}
+
+void CabbageComboBox::addFileItems (const Array<File>& files)
+{
+    folderFiles = files;
+    //addItem ("Select..", 1);
+    StringArray tempStrings;
+    for (int i = 0; i < folderFiles.size(); ++i)
+        tempStrings.add(folderFiles[i].getFileNameWithoutExtension());
+
+    if(stringItems == tempStrings)
+        return;
+    else
+    {
+        clear (dontSendNotification);
+        stringItems.clear();
+    }
+    
+    for ( int i = 0; i < folderFiles.size(); i++)
+    {
+        stringItems.add(folderFiles[i].getFileNameWithoutExtension());
+        addItem (folderFiles[i].getFileNameWithoutExtension(), i + 1);
+    }
+
+    if(currentValueAsText.isNotEmpty())
+        setText(File(getCsdFile()).getParentDirectory().getChildFile(currentValueAsText).getFileNameWithoutExtension());
+
+    var items;
+    for(auto& s : folderFiles)
+        items.append(s.getFileNameWithoutExtension());
+    
+    CabbageWidgetData::setProperty(widgetData, CabbageIdentifierIds::text, items, this);
+
+    if (selectionPending && folderFiles.size() > 0)
+    {
+        selectionPending = false;
+
+        if (isStringCombo)
+            selectStringItem();
         else
-        {
-            clear (dontSendNotification);
-            stringItems.clear();
-        }
-        
-        for ( int i = 0; i < folderFiles.size(); i++)
-        {
-            stringItems.add(folderFiles[i].getFileNameWithoutExtension());
-            addItem (folderFiles[i].getFileNameWithoutExtension(), i + 1);
-        }
+            setSelectedItemIndex (getValue() - 1, dontSendNotification);
+    }
+}
 
-        if(currentValueAsText.isNotEmpty())
-            setText(File(getCsdFile()).getParentDirectory().getChildFile(currentValueAsText).getFileNameWithoutExtension());
+void CabbageComboBox::selectStringItem()
+{
+    int index = stringItems.indexOf (currentValueAsText);
 
-        var items;
-        for(auto& s : folderFiles)
-            items.append(s.getFileNameWithoutExtension());
-        
-        CabbageWidgetData::setProperty(wData, CabbageIdentifierIds::text, items, this);
+    //this index if different for strings and files?
+    if (index >= 0)
+        setSelectedItemIndex (index, dontSendNotification);
+    else
+        setSelectedItemIndex (0, dontSendNotification);
+
+    if (currentValueAsText.containsOnly("0123456789.-"))
+    {
+        index = currentValueAsText.getIntValue();
     }
 
+    if(CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::filetype).isNotEmpty())
+        owner->sendChannelStringDataToCsound(getChannel(), folderFiles[index].getFileNameWithoutExtension());
+    else
+        owner->sendChannelStringDataToCsound(getChannel(), stringItems[index]);
 }
 
 void CabbageComboBox::comboBoxChanged (ComboBox* combo) //this listener is only enabled when combo is loading presets or strings...
@@ -544,11 +568,9 @@ void CabbageComboBox::valueTreePropertyChanged (ValueTree& valueTree, const Iden
                 addItemsToCombobox(valueTree);
         }
 
-        if (CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::refreshfiles)==1)
-        {
-            CabbageWidgetData::setNumProp(valueTree, CabbageIdentifierIds::refreshfiles, 0);
-            addItemsToCombobox (valueTree);
-        }
+        //populate() from an identchannel, the items only change if the directory has
+        if (prop == CabbageIdentifierIds::refreshfiles)
+            directoryIndex->rescan (this);
         
         handleCommonUpdates(this, valueTree, prop);
     }
@@ -30,7 +30,8 @@ class CabbageComboBox
     : public ComboBox,
       public ValueTree::Listener,
       public CabbageWidgetBase,
-      public ComboBox::Listener
+      public ComboBox::Listener,
+      private CabbageDirectoryIndex::Listener
 {
     int offX, offY, offWidth, offHeight, pivotx, pivoty, refresh;
     String name, tooltipText, caption, text, filetype, workingDir;
@@ -47,6 +48,12 @@ class CabbageComboBox
     CabbageLookAndFeel2 lookAndFeel;
     File presetFile;
     int currentItemIndex = 0;
+    bool selectionPending = false;
+    SharedResourcePointer<CabbageDirectoryIndex> directoryIndex;
+
+    void directoryIndexChanged (const Array<File>& files) override;
+    void addFileItems (const Array<File>& files);
+    void selectStringItem();
 public:
 
     CabbageComboBox (ValueTree cAttr, CabbagePluginEditor* _owner);
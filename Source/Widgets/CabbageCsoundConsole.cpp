@@ -74,11 +74,13 @@ void CabbageCsoundConsole::timerCallback()
     }
     else
     {
-        const String csoundOutputString = owner->getCsoundOutputFromProcessor();
+        //the processor only keeps the most recent output, so the console never grows without bound
+        String csoundOutputString;
 
-        if (csoundOutputString.isNotEmpty())
+        if (owner->getCsoundOutputSnapshotFromProcessor (csoundOutputString, lastOutputVersionSeen))
         {
-            insertTextAtCaret (csoundOutputString);
+            setText (csoundOutputString, false);
+            moveCaretToEnd();
         }
     }
 }
@@ -55,6 +55,7 @@ public:
 
 private:
     bool monospaced = false;
+    int lastOutputVersionSeen = -1;
     Font monospacedFont;
     Font defaultFont;
 };
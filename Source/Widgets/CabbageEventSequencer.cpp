@@ -46,6 +46,14 @@ CabbageEventSequencer::CabbageEventSequencer (ValueTree wData, CabbagePluginEdit
     setColours(wData);
     updateCurrentStepPosition();
 
+	//matrix belongs to processor, if it's already there the editor was reopened and the cells are still in it
+    if (! owner->createEventMatrix(numColumns, numRows, getChannel(), orientation == "vertical"))
+    {
+        for( int x = 0 ; x < numColumns ; x++)
+            for( int y = 0 ; y < numRows ; y++)
+                getEditor(x, y)->setText(owner->getEventMatrixData(x, y, getChannel()), false);
+    }
+
     var props = CabbageWidgetData::getProperty(wData, CabbageIdentifierIds::celldata);
 
     if (props.size()==3)
@@ -53,17 +61,13 @@ CabbageEventSequencer::CabbageEventSequencer (ValueTree wData, CabbagePluginEdit
         setCellData(int(props[0]), int(props[1]), props[2].toString());
     }
 
-	//matrix belongs to processor..
-    owner->createEventMatrix(numColumns, numRows, getChannel());
-    //init matrix data:
-    for( int x = 0 ; x < numColumns ; x++)
-        for( int y = 0 ; y < numRows ; y++)
-            owner->setEventMatrixData(x, y, getChannel(), String());
-
+    updateSequencerTiming(wData);
+    startTimerHz(30);
 }
 
 CabbageEventSequencer::~CabbageEventSequencer()
 {
+    stopTimer();
     widgetData.removeListener(this);
     cells.getUnchecked (0)->clear();
     cells.clear();
@@ -177,16 +181,55 @@ void CabbageEventSequencer::setColours(ValueTree wData)
     }
 }
 
+void CabbageEventSequencer::updateSequencerTiming(ValueTree wData)
+{
+    owner->setEventMatrixTiming(getChannel(),
+                                CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::stepsize),
+                                CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::swing),
+                                CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::bpm),
+                                CabbageWidgetData::getProperty(wData, CabbageIdentifierIds::tracklengths));
+}
+
+void CabbageEventSequencer::timerCallback()
+{
+    //without a stepSize() the steps still come from the widget's value
+    if (CabbageWidgetData::getNumProp(widgetData, CabbageIdentifierIds::stepsize) <= 0)
+    {
+        if (! currentSteps.isEmpty())
+        {
+            currentSteps.clear();
+            updateCurrentStepPosition();
+        }
+
+        return;
+    }
+
+    const int numTracks = orientation == "vertical" ? numColumns : numRows;
+    Array<int> steps;
+
+    for (int track = 0; track < numTracks; track++)
+        steps.add(owner->getEventMatrixCurrentStep(getChannel(), track));
+
+    if (steps != currentSteps)
+    {
+        currentSteps.swapWith(steps);
+        updateCurrentStepPosition();
+    }
+}
+
 void CabbageEventSequencer::updateCurrentStepPosition()
 {
     const MessageManagerLock j;
 
+    //tracks can be different lengths, so each one gets its own highlighted step
+    auto getStep = [this](int track) { return isPositiveAndBelow(track, currentSteps.size()) ? currentSteps.getUnchecked(track) : currentBeat; };
+
     if(orientation == "vertical")
     {
         for (int x = 0; x < numColumns; x++)
             for (int y = 0; y < numRows; y++)
             {
-                if (currentBeat == y)
+                if (getStep(x) == y)
                     getEditor(x, y)->setColour(TextEditor::backgroundColourId, Colour::fromString(
                             CabbageWidgetData::getStringProp(widgetData, CabbageIdentifierIds::highlightcolour)));
                 else
@@ -203,7 +246,7 @@ void CabbageEventSequencer::updateCurrentStepPosition()
         {
             for (int x = 0; x < numColumns; x++)
             {
-                if (currentBeat == x)
+                if (getStep(y) == x)
                     getEditor(x, y)->setColour(TextEditor::backgroundColourId, Colour::fromString(
                             CabbageWidgetData::getStringProp(widgetData, CabbageIdentifierIds::highlightcolour)));
                 else
@@ -251,8 +294,7 @@ void CabbageEventSequencer::setCellData(int col, int row, const String data)
 	if (col<numColumns && row<numRows)
 	{
 		getEditor(col, row)->setText(data.trimStart());
-		getEditor(col, row)->setText(data.trimStart());
-		owner->setEventMatrixData(col, row, getChannel(), newData);
+		owner->setEventMatrixData(col, row, getChannel(), newData, data.trimStart());
 	}
 
 }
@@ -334,6 +376,12 @@ void CabbageEventSequencer::valueTreePropertyChanged (ValueTree& valueTree, cons
         }
     }
 
+    else if(prop == CabbageIdentifierIds::stepsize || prop == CabbageIdentifierIds::swing
+            || prop == CabbageIdentifierIds::bpm || prop == CabbageIdentifierIds::tracklengths)
+    {
+        updateSequencerTiming(valueTree);
+    }
+
     else
     {
         repaint();
@@ -24,7 +24,7 @@
 
 class CabbagePluginEditor;
 
-class CabbageEventSequencer : public Component, public ValueTree::Listener, public CabbageWidgetBase, public KeyListener
+class CabbageEventSequencer : public Component, public ValueTree::Listener, public CabbageWidgetBase, public KeyListener, private Timer
 {
 public:
 
@@ -41,6 +41,8 @@ public:
     void setCellData(int col, int row, const String data);
     void updateCurrentStepPosition();
     void arrangeTextEditors(ValueTree wData);
+    void updateSequencerTiming(ValueTree wData);
+    void timerCallback() override;
 
     //ValueTree::Listener virtual methods....
     void valueTreePropertyChanged (ValueTree& valueTree, const Identifier&) override;
@@ -61,6 +63,7 @@ private:
     int numColumns = 0;
     int numRows = 0;
     int currentBeat = 0;
+    Array<int> currentSteps;    //one per track, while the processor's sequencer is running
     int numbersWidth = 20;
     Viewport vp;
     Component seqContainer;
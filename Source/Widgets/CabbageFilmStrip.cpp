@@ -0,0 +1,113 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#include "CabbageFilmStrip.h"
+
+//==============================================================================
+CabbageFilmStripCache::Atlas::Atlas (const Image& strip, int numFrames, int width, int height)
+    : frameWidth (width), frameHeight (height)
+{
+    const int framesPerRow = (int) std::ceil (std::sqrt ((double) numFrames));
+    const int numRows = (numFrames + framesPerRow - 1) / framesPerRow;
+    const int sourceFrameHeight = strip.getHeight() / numFrames;
+
+    //scaling a frame up in the atlas adds no detail, so large sliders scale up when drawing instead
+    const double scale = jmin (jmin (1.0, strip.getWidth() / (double) width, sourceFrameHeight / (double) height),
+                               maxAtlasSize / (double) (framesPerRow * width),
+                               maxAtlasSize / (double) (numRows * height));
+
+    tileWidth = jmax (1, (int) (width * scale));
+    tileHeight = jmax (1, (int) (height * scale));
+
+    image = Image (Image::ARGB, framesPerRow * tileWidth, numRows * tileHeight, true);
+    Graphics g (image);
+    g.setImageResamplingQuality (Graphics::highResamplingQuality);
+
+    for (int i = 0; i < numFrames; i++)
+    {
+        const juce::Rectangle<int> frameBounds ((i % framesPerRow) * tileWidth, (i / framesPerRow) * tileHeight, tileWidth, tileHeight);
+        g.drawImage (strip, frameBounds.getX(), frameBounds.getY(), tileWidth, tileHeight,
+                     0, i * sourceFrameHeight, strip.getWidth(), sourceFrameHeight);
+        frames.add (image.getClippedImage (frameBounds));
+    }
+}
+
+void CabbageFilmStripCache::Atlas::drawFrame (Graphics& g, float proportion, juce::Rectangle<float> bounds) const
+{
+    if (frames.isEmpty() || bounds.isEmpty())
+        return;
+
+    const int index = jlimit (0, frames.size() - 1, int (proportion * (frames.size() - 1)));
+
+    //at the scale the atlas was built for this is a straight copy of the frame's pixels
+    g.drawImageTransformed (frames.getReference (index),
+                            AffineTransform::scale (bounds.getWidth() / (float) tileWidth, bounds.getHeight() / (float) tileHeight)
+                                .translated (bounds.getX(), bounds.getY()));
+}
+
+//==============================================================================
+std::shared_ptr<const CabbageFilmStripCache::Atlas> CabbageFilmStripCache::getAtlas (const File& stripFile, int numFrames, int frameWidth, int frameHeight)
+{
+    if (numFrames <= 0 || frameWidth <= 0 || frameHeight <= 0)
+        return nullptr;
+
+    const std::string key = (stripFile.getFullPathName() + ":" + String (stripFile.getLastModificationTime().toMilliseconds()) + ":"
+                             + String (numFrames) + ":" + String (frameWidth) + "x" + String (frameHeight)).toStdString();
+
+    if (auto atlas = atlases[key].lock())
+        return atlas;
+
+    //drop entries whose sliders have all gone before adding another
+    for (auto it = atlases.begin(); it != atlases.end();)
+        it = it->second.expired() ? atlases.erase (it) : std::next (it);
+
+    const Image strip = loadStrip (stripFile);
+
+    if (strip.isNull() || strip.getHeight() < numFrames)
+        return nullptr;
+
+    auto atlas = std::make_shared<const Atlas> (strip, numFrames, frameWidth, frameHeight);
+    atlases[key] = atlas;
+    return atlas;
+}
+
+bool CabbageFilmStripCache::isValidStrip (const File& stripFile, int numFrames)
+{
+    if (numFrames <= 0 || ! stripFile.existsAsFile())
+        return false;
+
+    const Image strip = loadStrip (stripFile);
+    return ! strip.isNull() && strip.getHeight() >= numFrames;
+}
+
+Image CabbageFilmStripCache::loadStrip (const File& stripFile)
+{
+    const int64 hashCode = stripFile.hashCode64() + stripFile.getLastModificationTime().toMilliseconds();
+    Image strip = ImageCache::getFromHashCode (hashCode);
+
+    if (strip.isNull())
+    {
+        strip = ImageFileFormat::loadFrom (stripFile);
+
+        if (strip.isValid())
+            ImageCache::addImageToCache (strip, hashCode);
+    }
+
+    return strip;
+}
@@ -0,0 +1,72 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGEFILMSTRIP_H_INCLUDED
+#define CABBAGEFILMSTRIP_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <unordered_map>
+
+//==============================================================================
+// Filmstrip frames, already cut out of the strip and scaled to the size they
+// are drawn at. Frames are packed into a roughly square atlas rather than one
+// tall image, which keeps long strips inside the texture size limits of GPU
+// renderers. Frames are never stored larger than they are in the strip, or
+// than fits in the atlas, and are scaled up when drawn instead. Each strip is
+// decoded once through JUCE's ImageCache, and an atlas is shared by every
+// slider that draws the same version of a strip at the same physical size. Sliders ask for a new atlas when their size or the display
+// scale changes, and an atlas goes away with the last slider using it.
+//==============================================================================
+class CabbageFilmStripCache
+{
+public:
+    class Atlas
+    {
+    public:
+        Atlas (const Image& strip, int numFrames, int frameWidth, int frameHeight);
+
+        //draws the frame that represents proportion, from 0 to 1, scaled to fit bounds
+        void drawFrame (Graphics& g, float proportion, juce::Rectangle<float> bounds) const;
+
+        int getNumFrames() const    {   return frames.size();   }
+        int getFrameWidth() const   {   return frameWidth;      }
+        int getFrameHeight() const  {   return frameHeight;     }
+
+    private:
+        Image image;
+        Array<Image> frames;        //subsections of image, so picking a frame doesn't copy anything
+        int frameWidth, frameHeight;
+        int tileWidth, tileHeight;  //the size frames are stored at in image
+    };
+
+    //returns nullptr if the file isn't an image, or is too small for numFrames
+    std::shared_ptr<const Atlas> getAtlas (const File& stripFile, int numFrames, int frameWidth, int frameHeight);
+
+    static bool isValidStrip (const File& stripFile, int numFrames);
+
+private:
+    static constexpr int maxAtlasSize = 4096;
+
+    //ImageCache only keys files by path, so the modification time is added to pick up edited strips
+    static Image loadStrip (const File& stripFile);
+
+    std::unordered_map<std::string, std::weak_ptr<const Atlas>> atlases;
+};
+
+#endif  // CABBAGEFILMSTRIP_H_INCLUDED
@@ -51,6 +51,13 @@ void CabbageForm::valueTreePropertyChanged (ValueTree& valueTree, const Identifi
         owner->setLatency(newLatency);
         latency = newLatency;
     }
+
+    const int newOversampling = CabbageWidgetData::getNumProp(valueTree, CabbageIdentifierIds::oversampling);
+    if(prop == CabbageIdentifierIds::oversampling && oversampling != newOversampling)
+    {
+        owner->setOversampling(newOversampling);
+        oversampling = newOversampling;
+    }
     
     const int useOpenGL = CabbageWidgetData::getNumProp(valueTree, CabbageIdentifierIds::openGL);
     if(useOpenGL != openGL)
@@ -33,7 +33,9 @@ public ValueTree::Listener
     Colour colour;
     CabbagePluginEditor* owner;
     int latency = 32;
+    int oversampling = 1;
     int openGL = 0;
+    int64 paintStartTicks = 0;
     
 public:
     
@@ -53,13 +55,39 @@ public:
     void setColour (Colour col)
     {
         colour = col;
+        //lets JUCE skip painting whatever is behind the form
+        setOpaque (colour.isOpaque());
     }
     
     void paint (Graphics& g)  override
     {
+        paintStartTicks = Time::getHighResolutionTicks();
         //g.setOpacity (0);
         g.fillAll (colour);
     }
+
+    void paintOverChildren (Graphics& g) override
+    {
+        ignoreUnused (g);
+        const double paintMs = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - paintStartTicks) * 1000.0;
+        paintStatistics.numFrames++;
+        paintStatistics.totalPaintMs += paintMs;
+        paintStatistics.maxPaintMs = jmax (paintStatistics.maxPaintMs, paintMs);
+    }
+
+    //time spent painting the form and all the widgets on it, read by the IDE's repaint cost overlay
+    struct PaintStatistics
+    {
+        int numFrames = 0;
+        double totalPaintMs = 0, maxPaintMs = 0;
+    };
+
+    PaintStatistics getAndResetPaintStatistics()
+    {
+        const PaintStatistics statistics = paintStatistics;
+        paintStatistics = {};
+        return statistics;
+    }
     
     bool isInterestedInFileDrag (const StringArray& /*files*/) override{ return true; }
     void fileDragEnter (const StringArray& /*files*/, int /*x*/, int /*y*/) override{}
@@ -64,8 +64,17 @@ void CabbageGroupBox::changeListenerCallback (ChangeBroadcaster* source)
     CabbageWidgetData::setNumProp (widgetData, CabbageIdentifierIds::visible, 0);
 }
 
+void CabbageGroupBox::paint (Graphics& g)
+{
+    layer.paint (g, *this, [this] (Graphics& layerGraphics) { GroupComponent::paint (layerGraphics); });
+}
+
 void CabbageGroupBox::valueTreePropertyChanged (ValueTree& valueTree, const Identifier& prop)
 {
+    //the setters below only repaint if something actually changed
+    if (CabbageLayerCache::affectsAppearance (prop))
+        layer.invalidate();
+
     if (CabbagePluginEditor::PopupDocumentWindow* parentComp = dynamic_cast<CabbagePluginEditor::PopupDocumentWindow*> (getParentComponent()))
     {
         const int parentIsVisible = CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::visible);
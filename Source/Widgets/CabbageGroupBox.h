@@ -35,6 +35,7 @@ class CabbageGroupBox : public GroupComponent, public ValueTree::Listener, publi
     File svgPath = {}, svgFile = {};
     int isVisible = true;
     CabbageLookAndFeel2 lookAndFeel;
+    CabbageLayerCache layer;
 public:
 
     CabbageGroupBox (ValueTree wData, CabbagePluginEditor* _owner);
@@ -51,6 +52,7 @@ public:
     void valueTreeParentChanged (ValueTree&) override {}
 
     void changeListenerCallback (ChangeBroadcaster* source)  override;
+    void paint (Graphics& g) override;
 
     ValueTree widgetData;
 
@@ -108,61 +108,66 @@ void CabbageImage::paint (Graphics& g)
     }
     else 
     {
-        if (isLineWidget)
+        layer.paint (g, *this, [this] (Graphics& layerGraphics) { paintImage (layerGraphics); });
+    }
+}
+
+void CabbageImage::paintImage (Graphics& g)
+{
+    if (isLineWidget)
+    {
+        g.setColour(mainColour);
+        g.fillRoundedRectangle(0, 0, getWidth(), getHeight(), 1);
+
+        g.setColour(CabbageUtilities::getBackgroundSkin());
+        g.fillRoundedRectangle(0, 0, getWidth() - 1, getHeight() - 1, 1);
+    }
+    else
+    {
+
+        if (imgFile.hasFileExtension(".svg"))
         {
-            g.setColour(mainColour);
-            g.fillRoundedRectangle(0, 0, getWidth(), getHeight(), 1);
+            CabbageLookAndFeel2::drawFromSVG(g, imgFile, 0, 0, getWidth(), getHeight(), AffineTransform());
+        }
+        else if (img.isValid())
 
-            g.setColour(CabbageUtilities::getBackgroundSkin());
-            g.fillRoundedRectangle(0, 0, getWidth() - 1, getHeight() - 1, 1);
+        {
+            g.drawImage(img, 0, 0, getWidth(), getHeight(), cropx, cropy,
+                cropwidth == 0 ? img.getWidth() : cropwidth,
+                cropheight == 0 ? img.getHeight() : cropheight);
         }
+
         else
         {
+            g.fillAll(Colours::transparentBlack);
+            g.setColour(mainColour);
 
-            if (imgFile.hasFileExtension(".svg"))
-            {
-                CabbageLookAndFeel2::drawFromSVG(g, imgFile, 0, 0, getWidth(), getHeight(), AffineTransform());
-            }
-            else if (img.isValid())
-
-            {
-                g.drawImage(img, 0, 0, getWidth(), getHeight(), cropx, cropy,
-                    cropwidth == 0 ? img.getWidth() : cropwidth,
-                    cropheight == 0 ? img.getHeight() : cropheight);
-            }
-
+            if (shape == "square")
+                g.fillRoundedRectangle(0, 0, getWidth(), getHeight(), corners);
             else
-            {
-                g.fillAll(Colours::transparentBlack);
-                g.setColour(mainColour);
-
-                if (shape == "square")
-                    g.fillRoundedRectangle(0, 0, getWidth(), getHeight(), corners);
-                else
-                    g.fillEllipse(lineThickness * .9f, lineThickness * .9f, getWidth() - lineThickness * 1.9f, getHeight() - lineThickness * 1.9f);
+                g.fillEllipse(lineThickness * .9f, lineThickness * .9f, getWidth() - lineThickness * 1.9f, getHeight() - lineThickness * 1.9f);
 
 
-                g.setColour(outlineColour);
+            g.setColour(outlineColour);
 
-                if (shape == "square")
-                    g.drawRoundedRectangle(0, 0, jmax(1, getWidth()), jmax(1, getHeight()), corners, lineThickness);
-                else
-                    g.drawEllipse(lineThickness / 2.f, lineThickness / 2.f, jmax(1, getWidth() - lineThickness), jmax(1, getHeight() - lineThickness), lineThickness);
-            }
+            if (shape == "square")
+                g.drawRoundedRectangle(0, 0, jmax(1, getWidth()), jmax(1, getHeight()), corners, lineThickness);
+            else
+                g.drawEllipse(lineThickness / 2.f, lineThickness / 2.f, jmax(1, getWidth() - lineThickness), jmax(1, getHeight() - lineThickness), lineThickness);
+        }
 
-            if (usesSVGElement)
-            {
-                g.fillAll(Colours::transparentBlack);
-                svg = (XmlDocument::parse(svgElement));
+        if (usesSVGElement)
+        {
+            g.fillAll(Colours::transparentBlack);
+            svg = (XmlDocument::parse(svgElement));
 
-                if (svg == nullptr)
-                    return;
+            if (svg == nullptr)
+                return;
 
-                if (svg != nullptr)
-                {
-                    drawable = Drawable::createFromSVG(*svg);
-                    drawable->draw(g, 1.f, AffineTransform());
-                }
+            if (svg != nullptr)
+            {
+                drawable = Drawable::createFromSVG(*svg);
+                drawable->draw(g, 1.f, AffineTransform());
             }
         }
     }
@@ -203,7 +208,8 @@ void CabbageImage::valueTreePropertyChanged (ValueTree& valueTree, const Identif
     outlineColour = Colour::fromString (CabbageWidgetData::getStringProp (valueTree, CabbageIdentifierIds::outlinecolour));
     mainColour = Colour::fromString (CabbageWidgetData::getStringProp (valueTree, CabbageIdentifierIds::colour));
     shape = CabbageWidgetData::getStringProp (valueTree, CabbageIdentifierIds::shape);
-    updateImage(valueTree);
+    if (prop == CabbageIdentifierIds::file)
+        updateImage(valueTree);
     cropy = CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::cropy);
     cropx = CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::cropx);
     cropwidth = CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::cropwidth);
@@ -222,7 +228,11 @@ void CabbageImage::valueTreePropertyChanged (ValueTree& valueTree, const Identif
     else if (prop == CabbageIdentifierIds::corners)
         corners = CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::corners);
         
-    repaint();
+    if (CabbageLayerCache::affectsAppearance (prop))
+    {
+        layer.invalidate();
+        repaint();
+    }
 }
 
 String CabbageImage::createSVG(ValueTree valueTree)
@@ -42,6 +42,7 @@ class CabbageImage : public Component, public ValueTree::Listener, public Cabbag
     std::unique_ptr<Drawable> drawable;
     std::unique_ptr<XmlElement> svg;
     std::unique_ptr<OpenGLGraphicsContextCustomShader> shader;
+    CabbageLayerCache layer;
 
 
     String glShaderCode {};
@@ -64,6 +65,7 @@ public:
 
     void valueTreePropertyChanged (ValueTree& valueTree, const Identifier&)  override;
     void paint (Graphics& g) override;
+    void paintImage (Graphics& g);
     String createSVG(ValueTree wData);
     void mouseDown (const MouseEvent& e) override;
 	void updateImage(ValueTree& valueTree);
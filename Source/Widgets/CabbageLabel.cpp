@@ -59,6 +59,11 @@ CabbageLabel::CabbageLabel (ValueTree wData, CabbagePluginEditor* _owner)
 }
 
 void CabbageLabel::paint (Graphics& g)
+{
+    layer.paint (g, *this, [this] (Graphics& layerGraphics) { paintLabel (layerGraphics); });
+}
+
+void CabbageLabel::paintLabel (Graphics& g)
 {
     g.setColour (Colour::fromString (colour));
     g.fillRoundedRectangle (getLocalBounds().toFloat(), corners);
@@ -84,7 +89,11 @@ void CabbageLabel::paint (Graphics& g)
 
 void CabbageLabel::setText (String _text)
 {
+    if (text == _text)
+        return;
+
     text = _text;
+    layer.invalidate();
     repaint();
 }
 
@@ -120,6 +129,9 @@ void CabbageLabel::valueTreePropertyChanged (ValueTree& valueTree, const Identif
 
     handleCommonUpdates (this, valueTree, prop);      //handle comon updates such as bounds, alpha, rotation, visible, etc
 
-    repaint();
-
+    if (CabbageLayerCache::affectsAppearance (prop))
+    {
+        layer.invalidate();
+        repaint();
+    }
 }
@@ -37,6 +37,7 @@ class CabbageLabel : public Component, public ValueTree::Listener, public Cabbag
     String text, colour, fontcolour, align;
     Justification textAlign;
 	int fontsize = 0;
+    CabbageLayerCache layer;
 
 public:
 
@@ -57,6 +58,7 @@ public:
 
     void resized() override {}
     void paint (Graphics& g)  override;
+    void paintLabel (Graphics& g);
     void mouseDown (const MouseEvent& e)  override;
     void setText (String _text);
 
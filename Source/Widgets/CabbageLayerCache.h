@@ -0,0 +1,93 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+#ifndef CABBAGELAYERCACHE_H_INCLUDED
+#define CABBAGELAYERCACHE_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "../CabbageIds.h"
+
+//==============================================================================
+// A bitmap of a widget's own painting, for widgets whose look only changes
+// when one of their properties does: groupboxes, images, labels, screws and
+// so on. Whenever something animating over or inside them repaints, the
+// bitmap is drawn instead of painting them again. It's rendered at the
+// physical pixel scale it's drawn at, so plugin scaling and high DPI
+// displays get a sharp copy, and is rendered again when that scale or the
+// widget's size changes, or when the widget calls invalidate(). Child
+// components are painted as usual on top of it.
+//==============================================================================
+class CabbageLayerCache
+{
+public:
+    template <typename PaintFunction>
+    void paint (Graphics& g, const Component& component, PaintFunction&& paintContent)
+    {
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const int width = component.getWidth(), height = component.getHeight();
+
+        if (width <= 0 || height <= 0)
+            return;
+
+        if (! image.isValid() || scale != imageScale || width != imageWidth || height != imageHeight)
+        {
+            image = Image (Image::ARGB, jmax (1, roundToInt (width * scale)), jmax (1, roundToInt (height * scale)), true);
+            imageScale = scale;
+            imageWidth = width;
+            imageHeight = height;
+
+            Graphics imageGraphics (image);
+            imageGraphics.addTransform (AffineTransform::scale (scale));
+            paintContent (imageGraphics);
+            ++numLayersRendered;
+        }
+
+        g.drawImageTransformed (image, AffineTransform::scale ((float) width / (float) image.getWidth(),
+                                                               (float) height / (float) image.getHeight()));
+    }
+
+    void invalidate()
+    {
+        image = {};
+    }
+
+    //false for properties that are handled by the component itself, such as its bounds, alpha or visibility, or that don't change how it looks
+    static bool affectsAppearance (const Identifier& prop)
+    {
+        using namespace CabbageIdentifierIds;
+
+        return ! (prop == value || prop == valuex || prop == valuey || prop == update || prop == refreshfiles
+                  || prop == bounds || prop == pos || prop == position || prop == size
+                  || prop == left || prop == top || prop == width || prop == height
+                  || prop == visible || prop == alpha || prop == rotate || prop == pivotx || prop == pivoty
+                  || prop == tofront || prop == movebehind || prop == popuptext || prop == channel || prop == identchannel);
+    }
+
+    //how many layers have been rendered since the process started, shown by the IDE's repaint cost overlay
+    static int getNumLayersRendered()      {   return numLayersRendered;   }
+
+private:
+    Image image;
+    float imageScale = 0;
+    int imageWidth = 0, imageHeight = 0;
+
+    static inline int numLayersRendered = 0;
+};
+
+#endif  // CABBAGELAYERCACHE_H_INCLUDED
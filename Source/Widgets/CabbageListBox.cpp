@@ -123,10 +123,10 @@ void CabbageListBox::resized()
 
 void CabbageListBox::addItemsToListbox (ValueTree wData)
 {
-    Array<File> dirFiles;
     stringItems.clear();
     folderFiles.clear();
     presets.clear();
+    directoryIndex->removeListener (this);
 
     //load items from text file
     if (CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::file).isNotEmpty())
@@ -189,19 +189,8 @@ void CabbageListBox::addItemsToListbox (ValueTree wData)
             listboxDir = File(getCsdFile()).getParentDirectory();
 
         filetype = CabbageWidgetData::getStringProp (wData, CabbageIdentifierIds::filetype);
-        listboxDir.findChildFiles (dirFiles, File::TypesOfFileToFind::findFilesAndDirectories, false, filetype);
-//        stringItems.add ("Select..");
-
-        for (int i = 0; i < dirFiles.size(); ++i)
-            folderFiles.add (dirFiles[i]);
-
-        folderFiles.sort();
-
-        for ( int i = 0; i < folderFiles.size(); i++)
-        {
-            stringItems.add (folderFiles[i].getFileNameWithoutExtension());
-        }
-
+        //the directory is listed on the index's thread, anything not known yet turns up in directoryIndexChanged()
+        addFileItems (directoryIndex->setDirectory (this, listboxDir, filetype, File::TypesOfFileToFind::findFilesAndDirectories));
     }
 
 
@@ -215,6 +204,25 @@ void CabbageListBox::addItemsToListbox (ValueTree wData)
     listBox.updateContent();
 }
 
+void CabbageListBox::directoryIndexChanged (const Array<File>& files)
+{
+    addFileItems (files);
+    listBox.updateContent();
+    listBox.repaint();
+}
+
+void CabbageListBox::addFileItems (const Array<File>& files)
+{
+    folderFiles = files;
+    stringItems.clear();
+//        stringItems.add ("Select..");
+
+    for ( int i = 0; i < folderFiles.size(); i++)
+    {
+        stringItems.add (folderFiles[i].getFileNameWithoutExtension());
+    }
+}
+
 void CabbageListBox::valueTreePropertyChanged (ValueTree& valueTree, const Identifier& prop)
 {
     if (prop == CabbageIdentifierIds::value)
@@ -292,11 +300,9 @@ void CabbageListBox::valueTreePropertyChanged (ValueTree& valueTree, const Ident
             workingDir = CabbageUtilities::expandDirectoryMacro(workingDir);
         }
 
-        if (CabbageWidgetData::getNumProp (valueTree, CabbageIdentifierIds::refreshfiles)==1)
-        {
-            CabbageWidgetData::setNumProp(valueTree, CabbageIdentifierIds::refreshfiles, 0);
-            //addItemsToListbox (valueTree);
-        }
+        //populate() from an identchannel, the rows only change if the directory has
+        if (prop == CabbageIdentifierIds::refreshfiles)
+            directoryIndex->rescan (this);
       
         listBox.repaint();
     }
@@ -19,14 +19,19 @@ class CabbagePluginEditor;
 
 // Add any new custom widgets here to avoid having to edit makefiles and projects
 // Each Cabbage widget should inherit from ValueTree listener, and CabbageWidgetBase
-class CabbageListBox : public Component, public ListBoxModel, public ValueTree::Listener, public CabbageWidgetBase
+class CabbageListBox : public Component, public ListBoxModel, public ValueTree::Listener, public CabbageWidgetBase, private CabbageDirectoryIndex::Listener
 {
     
     Font userFont;
+    SharedResourcePointer<CabbageDirectoryIndex> directoryIndex;
+
+    void directoryIndexChanged (const Array<File>& files) override;
+    void addFileItems (const Array<File>& files);
 public:
 
     CabbageListBox (ValueTree wData, CabbagePluginEditor* _owner);
     ~CabbageListBox() override {
+        directoryIndex->removeListener(this);
         widgetData.removeListener(this);
         setLookAndFeel(nullptr);
     }
@@ -128,16 +128,21 @@ widgetData (wData)
 //==============================================================================
 void CabbageScrew::paint (Graphics& g)
 {
-
-    drawFromSVG(g, svgText, 0, 0, getWidth(), getHeight(), AffineTransform());
-
+    layer.paint (g, *this, [this] (Graphics& layerGraphics) {
+        drawFromSVG(layerGraphics, svgText, 0, 0, getWidth(), getHeight(), AffineTransform());
+    });
 }
 
 //==============================================================================
 void CabbageScrew::valueTreePropertyChanged (ValueTree& valueTree, const Identifier& prop)
 {
     handleCommonUpdates (this, valueTree, prop);
-    repaint();
+
+    if (CabbageLayerCache::affectsAppearance (prop))
+    {
+        layer.invalidate();
+        repaint();
+    }
 }
 
 
@@ -354,14 +359,21 @@ widgetData (wData)
 //==============================================================================
 void CabbagePort::paint (Graphics& g)
 {
-    drawFromSVG(g, svgText, 0, 0, getWidth(), getHeight(), AffineTransform());
+    layer.paint (g, *this, [this] (Graphics& layerGraphics) {
+        drawFromSVG(layerGraphics, svgText, 0, 0, getWidth(), getHeight(), AffineTransform());
+    });
 }
 
 //==============================================================================
 void CabbagePort::valueTreePropertyChanged (ValueTree& valueTree, const Identifier& prop)
 {
     handleCommonUpdates (this, valueTree,  prop);
-    repaint();
+
+    if (CabbageLayerCache::affectsAppearance (prop))
+    {
+        layer.invalidate();
+        repaint();
+    }
 }
 
 
@@ -67,6 +67,7 @@ class CabbageScrew : public Component, public ValueTree::Listener, public Cabbag
     Image img;
     String svgText;
     CabbagePluginEditor* owner = {};
+    CabbageLayerCache layer;
 
 public:
 
@@ -99,6 +100,7 @@ class CabbagePort : public Component, public ValueTree::Listener, public Cabbage
     Image img;
     String svgText;
     CabbagePluginEditor* owner = {};
+    CabbageLayerCache layer;
 
 public:
 
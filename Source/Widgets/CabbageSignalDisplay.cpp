@@ -73,10 +73,58 @@ CabbageSignalDisplay::CabbageSignalDisplay (ValueTree wData, CabbagePluginEditor
         addAndMakeVisible (zoomOutButton);
     }
 
+    //the sonogram colour only depends on the level, so look it up rather than converting from HSV for every pixel
+    for (int i = 0; i < 256; i++)
+    {
+        const float level = i / 255.f;
+        sonogramColours[i] = Colour::fromHSV (level, 1.0f, level, 1.0f).getPixelARGB();
+    }
+
     const int newUpdateRate = CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::updaterate);
     startTimer (newUpdateRate);
 }
 
+//====================================================================================
+void CabbageSignalDisplay::updatePixelMapping (float skewToUse)
+{
+    const int width = getWidth();
+
+    if (width == mappedWidth && leftPos == mappedLeftPos && scopeWidth == mappedScopeWidth
+        && vectorSize == mappedVectorSize && skewToUse == mappedSkew)
+        return;
+
+    mappedWidth = width;
+    mappedLeftPos = leftPos;
+    mappedScopeWidth = scopeWidth;
+    mappedVectorSize = vectorSize;
+    mappedSkew = skewToUse;
+
+    pixelToPoint.resize (width + 1);
+    const float range = (float) jmax (1, scopeWidth - leftPos);
+
+    for (int x = 0; x <= width; x++)
+    {
+        const float proportion = jlimit (0.f, 1.f, (x - leftPos) / range);
+        const float skewed = skewToUse == 1.f ? proportion : std::pow (proportion, skewToUse);
+        pixelToPoint.set (x, jlimit (0, vectorSize, roundToInt (skewed * vectorSize)));
+    }
+}
+
+//====================================================================================
+void CabbageSignalDisplay::updateSonogramMapping()
+{
+    const int imageHeight = spectrogramImage.getHeight();
+
+    if (sonogramRowToPoint.size() == imageHeight && sonogramVectorSize == vectorSize)
+        return;
+
+    sonogramVectorSize = vectorSize;
+    sonogramRowToPoint.resize (imageHeight);
+
+    for (int y = 0; y < imageHeight; y++)
+        sonogramRowToPoint.set (y, jlimit (0, vectorSize - 1, jmap (y, 0, imageHeight, 0, vectorSize)));
+}
+
 //====================================================================================
 void CabbageSignalDisplay::setBins (int min, int max)
 {
@@ -165,18 +213,31 @@ void CabbageSignalDisplay::drawSonogram()
 {
     const int rightHandEdge = spectrogramImage.getWidth() - 2;
     const int imageHeight = spectrogramImage.getHeight();
+    const float* points = signalFloatArray.getRawDataPointer();
 
+    updateSonogramMapping();
     spectrogramImage.moveImageSection (0, 0, 1, 0, rightHandEdge, imageHeight);
 
-    Graphics g (spectrogramImage);
-    Range<float> maxLevel = FloatVectorOperations::findMinAndMax (signalFloatArray.getRawDataPointer(), signalFloatArray.size());
+    const float maxLevel = FloatVectorOperations::findMaximum (points, signalFloatArray.size());
 
-    for (int y = 0; y < imageHeight; y++)
+    //write the new column straight into the image rather than drawing a line per row
+    Image::BitmapData column (spectrogramImage, rightHandEdge, 0, 2, imageHeight, Image::BitmapData::writeOnly);
+
+    for (int y = 1; y <= imageHeight; y++)
     {
-        const int index = jmap (y, 0, imageHeight, 0, vectorSize);
-        const float level = jmap (signalFloatArray[index], 0.0f, jmax (maxLevel.getEnd(), signalFloatArray[index] + 0.1f), 0.0f, 1.0f);
-        g.setColour (Colour::fromHSV (level, 1.0f, level, 1.0f));
-        g.drawHorizontalLine (imageHeight - y, rightHandEdge, rightHandEdge + 2);
+        const float value = points[sonogramRowToPoint.getUnchecked (imageHeight - y)];
+        const float level = jlimit (0.f, 1.f, value / jmax (maxLevel, value + 0.1f));
+        const PixelARGB& colour = sonogramColours[roundToInt (level * 255.f)];
+
+        for (int x = 0; x < 2; x++)
+        {
+            uint8* pixel = column.getPixelPointer (x, y - 1);
+
+            if (column.pixelFormat == Image::RGB)
+                reinterpret_cast<PixelRGB*> (pixel)->set (colour);
+            else
+                reinterpret_cast<PixelARGB*> (pixel)->set (colour);
+        }
     }
 }
 
@@ -184,73 +245,98 @@ void CabbageSignalDisplay::drawSonogram()
 void CabbageSignalDisplay::drawSpectroscope (Graphics& g)
 {
     const int offset = isScrollbarShowing == true ? scrollbarHeight : 0;
-    const int height = getHeight() - offset;
-    float prevY = height;
-    float prevX = leftPos;
-    int prevAmp = 0;
-    
-    
-    Path p;
-    p.startNewSubPath(leftPos, height);
-    for (int i = 0; i < vectorSize; i+=2)
+    const float height = getHeight() - offset;
+    const float* points = signalFloatArray.getRawDataPointer();
+
+    updatePixelMapping (skew);
+
+    //one point per pixel column, taking the loudest bin that falls into it
+    signalPath.clear();
+    signalPath.startNewSubPath (0, height);
+
+    for (int x = 0; x < mappedWidth; x++)
     {
-        const int position = jmap (i, 0, vectorSize, leftPos, scopeWidth);
-        
-        
-        int index = (std::pow(float(i)/(float)vectorSize, skew)) * vectorSize;
-        const int amp = ((signalFloatArray[index] * 10 * height)) * 0.5f;
-        //const int amp = (signalFloatArray[i] * 5 * height);
-
-        g.setColour (colour);
-
-        p.addLineSegment(Line<float>(position, prevY, position, height - amp), .5f);
-        
-//        g.drawLine(position, prevY, position, height - amp);
-        prevX = position;
-        prevY = height-amp;
-        //g.drawVerticalLine (position, height - amp, height);
+        const int start = pixelToPoint.getUnchecked (x);
+
+        if (start >= vectorSize)
+            break;
+
+        const int numPoints = jmax (1, pixelToPoint.getUnchecked (x + 1) - start);
+        const float amp = FloatVectorOperations::findMaximum (points + start, numPoints) * 5 * height;
+        signalPath.lineTo ((float) x, jmax (0.f, height - amp));
     }
-    
-    g.strokePath(p, PathStrokeType(1));
-    int test;
+
+    g.setColour (colour);
+    g.strokePath (signalPath, PathStrokeType (1));
 }
 
 //====================================================================================
 void CabbageSignalDisplay::drawWaveform (Graphics& g)
 {
     const int offset = isScrollbarShowing == true ? scrollbarHeight : 0;
-    const int height = getHeight() - offset;
-    int prevXPos = 0;
-    int prevYPos = jmap (signalFloatArray[0]*-1.f, -1.f, 1.f, 0.f, 1.f) * height;
+    const float height = getHeight() - offset;
+    const float* points = signalFloatArray.getRawDataPointer();
+    auto toY = [height] (float sample) { return (1.f - sample) * .5f * height; };
 
-    for (int i = 0; i < vectorSize; i++)
+    updatePixelMapping (1.f);
+
+    //reduce the signal to its min and max in each pixel column and draw it as a single path
+    signalPath.clear();
+
+    for (int x = 0; x < mappedWidth; x++)
     {
-        const int position = jmap (i, 0, vectorSize, leftPos, scopeWidth);
-        const int amp = jmap (signalFloatArray[i]*-1.f, -1.f, 1.f, 0.f, 1.f) * height;
-        g.setColour (colour);
-        g.drawLine (prevXPos, prevYPos, position, amp, lineThickness);
-        prevXPos = position;
-        prevYPos = amp;
+        const int start = pixelToPoint.getUnchecked (x);
+
+        if (start >= vectorSize)
+            break;
+
+        const int numPoints = pixelToPoint.getUnchecked (x + 1) - start;
+
+        if (numPoints > 1)
+        {
+            const Range<float> minMax = FloatVectorOperations::findMinAndMax (points + start, numPoints);
+
+            if (x == 0)
+                signalPath.startNewSubPath (0, toY (minMax.getEnd()));
+            else
+                signalPath.lineTo ((float) x, toY (minMax.getEnd()));
+
+            signalPath.lineTo ((float) x, toY (minMax.getStart()));
+        }
+        else if (x == 0)
+            signalPath.startNewSubPath (0, toY (points[start]));
+        else
+            signalPath.lineTo ((float) x, toY (points[start]));
     }
+
+    g.setColour (colour);
+    g.strokePath (signalPath, PathStrokeType ((float) lineThickness));
 }
 
 //====================================================================================
 void CabbageSignalDisplay::drawLissajous (Graphics& g)
 {
     const int offset = isScrollbarShowing == true ? scrollbarHeight : 0;
-    const int height = getHeight() - offset;
-    int prevXPos = jmap (signalFloatArray[0], -1.f, 1.f, (float)leftPos, (float)scopeWidth);;
-    int prevYPos = jmap (signalFloatArray2[1], -1.f, 1.f, 0.f, 1.f) * height;
+    const float height = getHeight() - offset;
+    const float* xPoints = signalFloatArray.getRawDataPointer();
+    const float* yPoints = signalFloatArray2.getRawDataPointer();
+
+    signalPath.clear();
+    signalPath.preallocateSpace (vectorSize * 3);
 
     for (int i = 0; i < vectorSize; i++)
     {
-        const int position = jmap (signalFloatArray[i], -1.f, 1.f, (float)leftPos, (float)scopeWidth);
-        const int amp = jmap (signalFloatArray2[i], -1.f, 1.f, 0.f, 1.f) * height;
-        g.setColour (colour);
-        g.drawLine (prevXPos, prevYPos, position, amp, lineThickness);
-        prevXPos = position;
-        prevYPos = amp;
+        const float position = jmap (xPoints[i], -1.f, 1.f, (float)leftPos, (float)scopeWidth);
+        const float amp = jmap (yPoints[i], -1.f, 1.f, 0.f, 1.f) * height;
+
+        if (i == 0)
+            signalPath.startNewSubPath (position, amp);
+        else
+            signalPath.lineTo (position, amp);
     }
+
+    g.setColour (colour);
+    g.strokePath (signalPath, PathStrokeType ((float) lineThickness));
 }
 
 //====================================================================================
@@ -289,10 +375,8 @@ void CabbageSignalDisplay::mouseMove (const MouseEvent& e)
 }
 
 //====================================================================================
-void CabbageSignalDisplay::setSignalFloatArray (Array<float, CriticalSection> _points)
+void CabbageSignalDisplay::signalFloatArrayUpdated()
 {
-    signalFloatArray.swapWith (_points);
-
     if (displayType == "lissajous" || displayType == "waveform")
         vectorSize = signalFloatArray.size() / 2;
     else
@@ -309,11 +393,9 @@ void CabbageSignalDisplay::setSignalFloatArray (Array<float, CriticalSection> _p
 }
 
 //====================================================================================
-void CabbageSignalDisplay::setSignalFloatArraysForLissajous (Array<float, CriticalSection> _points1, Array<float, CriticalSection> _points2)
+void CabbageSignalDisplay::signalFloatArraysForLissajousUpdated()
 {
-    signalFloatArray.swapWith (_points1);
-    signalFloatArray2.swapWith (_points2);
-    vectorSize = signalFloatArray.size();
+    vectorSize = jmin (signalFloatArray.size(), signalFloatArray2.size());
 
     if (vectorSize > 0)
     {
@@ -324,27 +406,34 @@ void CabbageSignalDisplay::setSignalFloatArraysForLissajous (Array<float, Critic
 //====================================================================================
 void CabbageSignalDisplay::timerCallback()
 {
-    const String variable = CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::signalvariable);
-    if (owner->shouldUpdateSignalDisplay(variable))
+    //points are copied straight into our own arrays, and only when Csound has published a new frame
+    const String signalDisplayType = CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::displaytype);
+
+    if (signalDisplayType != "lissajous")
     {
-        
-        const String signalDisplayType = CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::displaytype);
+        const String variable = CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::signalvariable);
 
-        if (signalDisplayType != "lissajous")
+        if (owner->getSignalDisplayPoints (variable, signalDisplayType, signalFloatArray, lastFrameSeen))
         {
-            setSignalFloatArray (owner->getArrayForSignalDisplay (variable, signalDisplayType));
+            signalFloatArrayUpdated();
+            repaint();
         }
-        else
-        {
-            signalVariables = CabbageWidgetData::getProperty (widgetData, CabbageIdentifierIds::signalvariable);
-
-            if (signalVariables.size() == 2)
-                setSignalFloatArraysForLissajous (owner->getArrayForSignalDisplay (signalVariables[0], signalDisplayType),
-                                                  owner->getArrayForSignalDisplay (signalVariables[1], signalDisplayType));
+    }
+    else
+    {
+        signalVariables = CabbageWidgetData::getProperty (widgetData, CabbageIdentifierIds::signalvariable);
 
+        if (signalVariables.size() == 2)
+        {
+            const bool firstUpdated = owner->getSignalDisplayPoints (signalVariables[0], signalDisplayType, signalFloatArray, lastFrameSeen);
+            const bool secondUpdated = owner->getSignalDisplayPoints (signalVariables[1], signalDisplayType, signalFloatArray2, lastFrameSeen2);
+
+            if (firstUpdated || secondUpdated)
+            {
+                signalFloatArraysForLissajousUpdated();
+                repaint();
+            }
         }
-
-        repaint();
     }
 }
 
@@ -45,8 +45,19 @@ class CabbageSignalDisplay : public Component, public ValueTree::Listener, publi
     float rotate;
     bool shouldPaint {false};
     int updateRate {200};
+    int lastFrameSeen = -1, lastFrameSeen2 = -1;
 
     Image spectrogramImage, spectroscopeImage;
+    Path signalPath;
+
+    //first point drawn in each pixel column, and in each sonogram row. These are only
+    //rebuilt when the size, zoom, scroll position, skew or number of points change
+    Array<int> pixelToPoint, sonogramRowToPoint;
+    int mappedWidth = -1, mappedLeftPos = 0, mappedScopeWidth = 0, mappedVectorSize = -1, sonogramVectorSize = -1;
+    float mappedSkew = 1;
+    PixelARGB sonogramColours[256];
+    void updatePixelMapping (float skewToUse);
+    void updateSonogramMapping();
     FrequencyRangeDisplayComponent freqRangeDisplay;
     Range<int> freqRange;
     float skew = 1;
@@ -77,8 +88,8 @@ public:
     void drawWaveform (Graphics& g);
     void drawLissajous (Graphics& g);
     void paint (Graphics& g) override;
-    void setSignalFloatArray (Array<float, CriticalSection> _points);
-    void setSignalFloatArraysForLissajous (Array<float, CriticalSection> _points1, Array<float, CriticalSection> _points2);
+    void signalFloatArrayUpdated();
+    void signalFloatArraysForLissajousUpdated();
     void resized() override;
     void mouseMove (const MouseEvent& e) override;
     void showPopup (String text);
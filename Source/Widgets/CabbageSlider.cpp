@@ -229,17 +229,18 @@ void CabbageSlider::paint(Graphics& g)
     if (isFilmStripSlider)
     {
         const float sliderPos = (float)slider.valueToProportionOfLength(slider.getValue());
+        const juce::Rectangle<float> bounds = sliderBounds.isArray() ? juce::Rectangle<float>((int)sliderBounds[0], (int)sliderBounds[1], (int)sliderBounds[2], (int)sliderBounds[3])
+                                                                     : filmStripBounds;
 
-        int sliderValue = sliderPos * (numFrames - 1);
+        //frames are scaled once to the size they're drawn at, and again only when that changes
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const int width = roundToInt(bounds.getWidth() * scale), height = roundToInt(bounds.getHeight() * scale);
 
-        if(!sliderBounds.isArray())
-        {
-        g.drawImage(filmStrip, filmStripBounds.getX(), filmStripBounds.getY(), filmStripBounds.getWidth(), filmStripBounds.getHeight(), 0, sliderValue * frameHeight, frameWidth, frameHeight);
-        }
-        else
-        {
-            g.drawImage(filmStrip, (int)sliderBounds[0], (int)sliderBounds[1], (int)sliderBounds[2], (int)sliderBounds[3], 0, sliderValue * frameHeight, frameWidth, frameHeight);
-        }
+        if (filmStripAtlas == nullptr || filmStripAtlas->getFrameWidth() != width || filmStripAtlas->getFrameHeight() != height)
+            filmStripAtlas = filmStripCache->getAtlas(filmStripFile, numFrames, width, height);
+
+        if (filmStripAtlas != nullptr)
+            filmStripAtlas->drawFrame(g, sliderPos, bounds);
     }
     else if (sliderBgImage.isValid())
     {
@@ -260,6 +261,7 @@ void CabbageSlider::initFilmStrip(ValueTree wData)
     numFrames = CabbageWidgetData::getNumProp(wData, CabbageIdentifierIds::filmstripframes);
     String path = CabbageWidgetData::getStringProp(wData, CabbageIdentifierIds::csdfile);
     File imageFile;
+    filmStripAtlas = nullptr;
     if (path.isEmpty())
     {
         imageFile = File::getCurrentWorkingDirectory().getChildFile(CabbageWidgetData::getStringProp(wData, CabbageIdentifierIds::filmstripimage)).getFullPathName();
@@ -272,14 +274,9 @@ void CabbageSlider::initFilmStrip(ValueTree wData)
     if (imageFile.existsAsFile())
     {
         isFilmStripSlider = true;
-        //ImageCache::addImageToCache(ImageFileFormat::loadFrom(imageFile), imageFile.hashCode64());
-        filmStrip = ImageCache::getFromFile(imageFile);
-        if (!filmStrip.isNull())
-        {
+        filmStripFile = imageFile;
+        if (CabbageFilmStripCache::isValidStrip(imageFile, numFrames))
             slider.getProperties().set("filmstrip", 1);
-            frameHeight = filmStrip.getHeight() / numFrames;
-            frameWidth = filmStrip.getWidth();
-        }
     }
 }
 void CabbageSlider::initialiseSlider(ValueTree wData, Slider& currentSlider)
@@ -22,6 +22,7 @@
 
 #include "../CabbageCommonHeaders.h"
 #include "CabbageWidgetBase.h"
+#include "CabbageFilmStrip.h"
 #include "../LookAndFeel/FlatButtonLookAndFeel.h"
 
 class CabbagePluginEditor;
@@ -138,10 +139,9 @@ class CabbageSlider
     FlatButtonLookAndFeel flatLookAndFeel;
     CabbageLookAndFeel2 lookAndFeel;
     int numFrames = 31;
-    bool imageIsNull = true;
-    Image filmStrip;
-    File imageFile;
-    int frameWidth = 32, frameHeight = 32;
+    File filmStripFile;
+    SharedResourcePointer<CabbageFilmStripCache> filmStripCache;
+    std::shared_ptr<const CabbageFilmStripCache::Atlas> filmStripAtlas;
    juce::Rectangle<float> filmStripBounds = {0, 0, 80, 80};
     Label filmStripValueBox;
     SliderThumb thumb;
@@ -21,6 +21,7 @@
 #define CABBAGEWIDGETBASE_H_INCLUDED
 
 #include "../CabbageCommonHeaders.h"
+#include "CabbageLayerCache.h"
 
 class CabbagePluginEditor;
 
@@ -364,6 +364,7 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, const String
             case HashStringToInt ("manufacturer"):
             case HashStringToInt ("mountPoint"):
             case HashStringToInt ("logger"):
+            case HashStringToInt ("logLevel"):
             case HashStringToInt ("parent"):
             case HashStringToInt ("namespace"):
             case HashStringToInt ("fileType"):
@@ -432,6 +433,12 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, const String
                 setFilmStrip(strTokens, widgetData);
                 break;
                 
+            case HashStringToInt ("guiRefresh"):
+                setProperty (widgetData, CabbageIdentifierIds::guirefresh, strTokens[0].trim().getFloatValue());
+                if (strTokens.size() > 1)
+                    setProperty (widgetData, CabbageIdentifierIds::guirefreshunit, strTokens[1].trim().removeCharacters ("\""));
+                break;
+                
                 
                 
                 //=========== floats ===============================
@@ -446,7 +453,6 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, const String
             case HashStringToInt ("initValue"):
             case HashStringToInt ("ffttableNumber"):
             case HashStringToInt ("fill"):
-            case HashStringToInt ("guiRefresh"):
             case HashStringToInt ("preCycles"):
             case HashStringToInt ("imgdebug"):
             case HashStringToInt ("increment"):
@@ -472,6 +478,7 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, const String
             case HashStringToInt ("minValue"):
             case HashStringToInt ("mouseInteraction"):
             case HashStringToInt ("outlineThickness"):
+            case HashStringToInt ("oversampling"):
             case HashStringToInt ("pivotX"):
             case HashStringToInt ("pivotY"):
             case HashStringToInt ("presetIgnore"):
@@ -482,8 +489,11 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, const String
             case HashStringToInt ("scrollbars"):
             case HashStringToInt ("sidechain"):
             case HashStringToInt ("sliderSkew"):
+            case HashStringToInt ("stepSize"):
             case HashStringToInt ("surrogatelinenumber"):
+            case HashStringToInt ("swing"):
             case HashStringToInt ("textBox"):
+            case HashStringToInt ("threads"):
             case HashStringToInt ("titleBarGradient"):
             case HashStringToInt ("trackerInsideRadius"):
             case HashStringToInt ("trackerOutsideRadius"):
@@ -584,6 +594,26 @@ void CabbageWidgetData::setCustomWidgetState (ValueTree widgetData, const String
                 setTableNumberArrays (strTokens, widgetData);
                 break;
                 
+            case HashStringToInt ("trackLengths"):
+            {
+                var lengths;
+
+                for (const auto& token : strTokens)
+                    lengths.append (token.trim().getIntValue());
+
+                setProperty (widgetData, identifier, lengths);
+                break;
+            }
+
+            case HashStringToInt ("ksmpsRange"):
+                if (strTokens.size() >= 2)
+                {
+                    setProperty (widgetData, CabbageIdentifierIds::ksmpsmin, strTokens[0].trim().getFloatValue());
+                    setProperty (widgetData, CabbageIdentifierIds::ksmpsmax, strTokens[1].trim().getFloatValue());
+                }
+
+                break;
+
             case HashStringToInt ("size"):
                 if (strTokens.size() >= 2)
                 {
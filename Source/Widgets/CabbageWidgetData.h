@@ -125,6 +125,7 @@ public:
     static Colour getColourFromText (String text);
     static String getCabbageCodeForIdentifier(ValueTree widgetData, const String);
     static String getCabbageCodeFromIdentifiers (ValueTree props, const String);
+    static ValueTree getDefaultWidgetState (const String& widgetText);
     //============================================================================
     static void setSVGText(ValueTree widgetData, StringArray tokens);
     static String getBoundsTextAsCabbageCode (juce::Rectangle<int> rect);
@@ -33,7 +33,13 @@ void CabbageWidgetData::setFormProperties (ValueTree widgetData, int ID)
     setProperty (widgetData, CabbageIdentifierIds::name, "form");
     setProperty (widgetData, CabbageIdentifierIds::type, "form");
     setProperty (widgetData, CabbageIdentifierIds::guirefresh, 128);
+    setProperty (widgetData, CabbageIdentifierIds::guirefreshunit, "kcycles");
     setProperty (widgetData, CabbageIdentifierIds::precycles, 0);
+    setProperty (widgetData, CabbageIdentifierIds::loglevel, "all");
+    setProperty (widgetData, CabbageIdentifierIds::threads, 1);
+    setProperty (widgetData, CabbageIdentifierIds::ksmpsmin, 0);
+    setProperty (widgetData, CabbageIdentifierIds::ksmpsmax, 0);
+    setProperty (widgetData, CabbageIdentifierIds::oversampling, 1);
     setProperty (widgetData, CabbageIdentifierIds::channel, "form");
     setProperty (widgetData, CabbageIdentifierIds::identchannel, "");
     setProperty(widgetData, CabbageIdentifierIds::automatable, 0.0f);
@@ -289,6 +295,9 @@ void CabbageWidgetData::setEventSequencerProperties (ValueTree widgetData, int I
     setProperty (widgetData, CabbageIdentifierIds::value, 1);
     setProperty (widgetData, CabbageIdentifierIds::numberofsteps, 16);
     setProperty (widgetData, CabbageIdentifierIds::bpm, 60);
+    setProperty (widgetData, CabbageIdentifierIds::stepsize, 0);
+    setProperty (widgetData, CabbageIdentifierIds::swing, 0);
+    setProperty (widgetData, CabbageIdentifierIds::tracklengths, var());
     setProperty (widgetData, CabbageIdentifierIds::cellwidth, 0);
     setProperty (widgetData, CabbageIdentifierIds::cellheight, 0);
 }
@@ -26,6 +26,30 @@ constexpr unsigned long long int HashStringToInt (const char* str, unsigned long
     return (*str == 0) ? hash : 101 * HashStringToInt (str + 1) + *str;
 }
 
+//===========================================================================
+// every identifier is compared against a freshly parsed widget of the same type, and that
+// tree only depends on the widget text, so it's parsed once rather than once per identifier.
+// Macro text makes the keys open ended, so the cache is dropped once it grows too big
+ValueTree CabbageWidgetData::getDefaultWidgetState (const String& widgetText)
+{
+    static constexpr int maxDefaultStates = 128;
+    static CriticalSection lock;
+    static HashMap<String, ValueTree> defaultStates;
+    const ScopedLock sl (lock);
+
+    if (! defaultStates.contains (widgetText))
+    {
+        if (defaultStates.size() >= maxDefaultStates)
+            defaultStates.clear();
+
+        ValueTree tempData ("tempTree");
+        setWidgetState (tempData, widgetText, -99);
+        defaultStates.set (widgetText, tempData);
+    }
+
+    return defaultStates[widgetText];
+}
+
 //===========================================================================
 // these methods will return Cabbage code based on data stored in widget tree
 String CabbageWidgetData::getCabbageCodeForIdentifier(ValueTree widgetData, String identifier)
@@ -183,9 +207,8 @@ String CabbageWidgetData::getCabbageCodeFromIdentifiers (ValueTree widgetData, c
     //remove widget type
     const String widgetType = CabbageWidgetData::getStringProp (widgetData, CabbageIdentifierIds::type);
     identifiersInLine.set(0, identifiersInLine[0].substring(identifiersInLine[0].indexOf(" ") + 1));
-    CabbageIdentifierStrings fullListOfIdentifierStrings;
-   
-    fullListOfIdentifierStrings.sort(true);
+    static const StringArray sortedIdentifierStrings = [] { CabbageIdentifierStrings strings; strings.sort(true); return strings; }();
+    StringArray fullListOfIdentifierStrings (sortedIdentifierStrings);
     
 
     var macroNames = CabbageWidgetData::getProperty (widgetData, CabbageIdentifierIds::macronames);
@@ -295,9 +318,8 @@ String CabbageWidgetData::getBoundsTextAsCabbageCode (Rectangle<int> rect)
 
 String CabbageWidgetData::getFilmStripTextAsCabbageCode(ValueTree widgetData, const String macroText)
 {
-    ValueTree tempData("tempTree");
     const String type = getStringProp(widgetData, CabbageIdentifierIds::type);
-    setWidgetState(tempData, type + " " + macroText, -99);
+    const ValueTree tempData = getDefaultWidgetState(type + " " + macroText);
 
     const String filmImage = getStringProp(widgetData, CabbageIdentifierIds::filmstripimage);
     const int numberOfFrames = getNumProp(widgetData, CabbageIdentifierIds::filmstripframes);
@@ -319,9 +341,8 @@ String CabbageWidgetData::getFilmStripTextAsCabbageCode(ValueTree widgetData, co
 
 String CabbageWidgetData::getNumericalValueTextAsCabbageCode (ValueTree widgetData, String identifier, const String macroText)
 {
-    ValueTree tempData ("tempTree");
     const String type = getStringProp (widgetData, CabbageIdentifierIds::type);
-    setWidgetState (tempData, type + " " + macroText, -99);
+    const ValueTree tempData = getDefaultWidgetState (type + " " + macroText);
     
     if (type.contains ("slider") && identifier == "range")
     {
@@ -424,9 +445,8 @@ String CabbageWidgetData::getNumericalValueTextAsCabbageCode (ValueTree widgetDa
 
 String CabbageWidgetData::getRotateTextAsCabbageCode (ValueTree widgetData, const String macroText)
 {
-    ValueTree tempData ("tempTree");
     const String type = getStringProp (widgetData, CabbageIdentifierIds::type);
-    setWidgetState (tempData, type + " " + macroText, -99);
+    const ValueTree tempData = getDefaultWidgetState (type + " " + macroText);
 
 if (getNumProp(widgetData, CabbageIdentifierIds::rotate) != getNumProp(tempData, CabbageIdentifierIds::rotate)
     || getNumProp(widgetData, CabbageIdentifierIds::pivotx) != getNumProp(tempData, CabbageIdentifierIds::pivotx)
@@ -444,9 +464,8 @@ return String();
 
 String CabbageWidgetData::getSimpleTextAsCabbageCode(ValueTree widgetData, String identifier, const String macroText)
 {
-    ValueTree tempData("tempTree");
     const String type = getStringProp(widgetData, CabbageIdentifierIds::type);
-    setWidgetState(tempData, type + " " + macroText, -99);
+    const ValueTree tempData = getDefaultWidgetState(type + " " + macroText);
 
 
     if (getStringProp(widgetData, identifier) != getStringProp(tempData, identifier))
@@ -460,9 +479,8 @@ String CabbageWidgetData::getSimpleTextAsCabbageCode(ValueTree widgetData, Strin
 
 String CabbageWidgetData::getImagesTextAsCabbageCode(ValueTree widgetData, const String macroText)
 {
-    ValueTree tempData("tempTree");
     const String type = getStringProp(widgetData, CabbageIdentifierIds::type);
-    setWidgetState(tempData, type + " " + macroText, -99);
+    const ValueTree tempData = getDefaultWidgetState(type + " " + macroText);
     String returnText = "";
 
     if (getStringProp(widgetData, CabbageIdentifierIds::imgbuttonon)
@@ -507,9 +525,8 @@ String CabbageWidgetData::getMultiItemNumbersAsCabbageCode(ValueTree widgetData,
 {
     var items = getProperty(widgetData, identifier);
     const Array<var>* array = items.getArray();
-    ValueTree tempData("tempTree");
     const String type = getStringProp(widgetData, CabbageIdentifierIds::type);
-    setWidgetState(tempData, type + " " + macroText, -99);
+    const ValueTree tempData = getDefaultWidgetState(type + " " + macroText);
     var tempItems = getProperty(tempData, identifier);
 
 
@@ -563,10 +580,8 @@ String CabbageWidgetData::getMultiItemTextAsCabbageCode (ValueTree widgetData, S
 
     var items = getProperty(widgetData, identifier);
     const Array<var>* array = items.getArray();
-    ValueTree tempData ("tempTree");
-    
     const String typeOfWidget = getProperty (widgetData, CabbageIdentifierIds::type);
-    setWidgetState (tempData, typeOfWidget + " " + macroText, -99);
+    const ValueTree tempData = getDefaultWidgetState (typeOfWidget + " " + macroText);
     var tempItems = getProperty (tempData, identifier);
     
     if(tempItems.equalsWithSameType(items))
@@ -647,10 +662,9 @@ String CabbageWidgetData::getWidgetArrayAsCabbageCode (ValueTree widgetData, con
 
 String CabbageWidgetData::getColoursTextAsCabbageCode (ValueTree widgetData, const String identifier, const String macroText)
 {
-    ValueTree tempData("tempTree");
     //tempData = widgetData.createCopy();
     const String type = getStringProp(widgetData, CabbageIdentifierIds::type);
-    setWidgetState(tempData, type + " " + macroText, -99);
+    const ValueTree tempData = getDefaultWidgetState(type + " " + macroText);
     String colourString;
     
     if (identifier == "colour:0" && type.contains("slider") == false && type != "combobox" && type != "listbox" && type != "image" && type != "gentable" && type != "soundfiler" && type != "encoder" && type != "label" && type!="textbox" && type!="xypad" && type!="groupbox")
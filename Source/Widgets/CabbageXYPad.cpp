@@ -155,7 +155,8 @@ void CabbageXYPad::changeListenerCallback (ChangeBroadcaster* source)
         pos.addXY (-ball.getWidth() / 2, -ball.getWidth() / 2);
         ball.setBounds (pos.getX(), pos.getY(), 20, 20);
 
-        setValues (xyAuto->getPosition().getX(), xyAuto->getPosition().getY());
+        //the automator has already updated the channels and host, so the sliders don't need to notify
+        setValues (xyAuto->getPosition().getX(), xyAuto->getPosition().getY(), false);
 
         if (xyAuto->getShouldRepaintBackground() == true)
         {
@@ -317,56 +318,97 @@ juce::Point<float> CabbageXYPad::getValueAsPosition (juce::Point<float> position
 
 void CabbageXYPad::setValues (float x, float y, bool notify)
 {
-    ignoreUnused(notify);
-    xAxis.setValue (x, sendNotification);
-    yAxis.setValue (minY + (maxY - y), sendNotification);
+    const auto notification = notify ? sendNotification : dontSendNotification;
+    xAxis.setValue (x, notification);
+    yAxis.setValue (minY + (maxY - y), notification);
     xValueLabel.setText (createValueText(x, 3, xPrefix, xPostfix), dontSendNotification);
     yValueLabel.setText (createValueText(minY + (maxY - y), 3, yPrefix, yPostfix), dontSendNotification);
 }
 //========================================================================
-XYPadAutomator::XYPadAutomator (String xyName, CabbagePluginParameter* xParam, CabbagePluginParameter* yParam, CabbagePluginProcessor* _owner)
-    : name (xyName), xParam (xParam), yParam (yParam), owner (_owner)
+XYPadAutomator::XYPadAutomator (String xyName, CabbagePluginParameter* xParam, CabbagePluginParameter* yParam, const ValueTree& wData)
+    : name (xyName), xParam (xParam), yParam (yParam),
+      xChannel (xParam != nullptr ? xParam->getChannel().toStdString() : std::string()),
+      yChannel (yParam != nullptr ? yParam->getChannel().toStdString() : std::string()),
+      widgetData (wData),
+      xMin (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::minx)),
+      xMax (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::maxx)),
+      yMin (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::miny)),
+      yMax (CabbageWidgetData::getNumProp (wData, CabbageIdentifierIds::maxy))
 {}
 
+void XYPadAutomator::start (const Line<float>& dragLine)
+{
+    //the pad used to move by 5% of the drag line every 20ms, keep the same speed
+    const float velocityScale = .05f / .02f;
+
+    startX = dragLine.getEndX();
+    startY = dragLine.getEndY();
+    startXVelocity = (dragLine.getEndX() - dragLine.getStartX()) * velocityScale;
+    startYVelocity = (dragLine.getEndY() - dragLine.getStartY()) * velocityScale;
+    repaintBackground = true;
+    state = starting;
+}
 
-void XYPadAutomator::timerCallback()
+void XYPadAutomator::stop()
 {
-    xValue += xValueIncrement;
-    position.setX (xValue);
+    state = stopped;
+}
 
-    yValue += yValueIncrement;
-    position.setY (yValue);
+bool XYPadAutomator::process (int numSamples, double sampleRate)
+{
+    int expected = starting;
 
-    // If a border is hit then the increment value should be reversed...
-    if (xValue <= xMin)
+    if (state.compare_exchange_strong (expected, moving))
     {
-        xValue = xMin;
-        xValueIncrement *= -1;
+        xValue = startX.load();
+        yValue = startY.load();
+        xVelocity = startXVelocity.load();
+        yVelocity = startYVelocity.load();
     }
-    else if (xValue >= xMax)
+    else if (expected != moving || sampleRate <= 0)
+        return false;
+
+    const double seconds = numSamples / sampleRate;
+    xValue += xVelocity * seconds;
+    yValue += yVelocity * seconds;
+
+    // If a border is hit then the ball is reflected back in and its direction reversed...
+    if (xValue <= xMin || xValue >= xMax)
     {
-        xValue = xMax;
-        xValueIncrement *= -1;
+        xValue = jlimit ((double) xMin, (double) xMax, xValue <= xMin ? 2.0 * xMin - xValue : 2.0 * xMax - xValue);
+        xVelocity *= -1;
     }
 
-    if (yValue <= yMin)
+    if (yValue <= yMin || yValue >= yMax)
     {
-        yValue = yMin;
-        yValueIncrement *= -1;
+        yValue = jlimit ((double) yMin, (double) yMax, yValue <= yMin ? 2.0 * yMin - yValue : 2.0 * yMax - yValue);
+        yVelocity *= -1;
     }
-    else if (yValue >= yMax)
+
+    currentX = (float) xValue;
+    currentY = (float) yValue;
+    positionChanged = true;
+    return true;
+}
+
+void XYPadAutomator::updateHostAndListeners (bool isPluginEditorOpen)
+{
+    if (! positionChanged.exchange (false))
+        return;
+
+    const float x = currentX.load();
+    const float y = yMin + (yMax - currentY.load());
+
+    //channels have already been written on the audio thread, this only lets the host record the movement
+    if (xParam != nullptr && yParam != nullptr)
     {
-        yValue = yMax;
-        yValueIncrement *= -1;
+        xParam->notifyHostOfValue (xParam->getNormalisableRange().convertTo0to1 (x));
+        yParam->notifyHostOfValue (yParam->getNormalisableRange().convertTo0to1 (y));
     }
 
-    if (owner->editorIsOpen && xParam != nullptr && yParam != nullptr) //only update GUI is editor is open
-    {
+    CabbageWidgetData::setNumProp (widgetData, CabbageIdentifierIds::valuex, x);
+    CabbageWidgetData::setNumProp (widgetData, CabbageIdentifierIds::valuey, y);
+
+    if (isPluginEditorOpen)
         sendSynchronousChangeMessage();
-    }
-    else
-    {
-        xParam->setValue (xValue / xMax);
-        yParam->setValue (yValue / yMax);
-    }
 }
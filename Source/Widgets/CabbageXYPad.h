@@ -124,108 +124,83 @@ public:
 };
 
 //=============================================================================
-class XYPadAutomator : public ChangeBroadcaster, public Timer
+// Ballistic motion for a flung XY pad. The motion is advanced by the processor
+// on the audio thread before each k-cycle, so it keeps moving at a steady rate
+// whether or not the editor is open. The message thread only picks up the
+// latest position to notify the host and repaint the pad.
+class XYPadAutomator : public ChangeBroadcaster
 {
     String name;
     CabbagePluginParameter* xParam, *yParam;
-    float xValue = 0;
-    float yValue = 0;
-    float xValueIncrement = 1;
-    float yValueIncrement = 1;
-    Line<float> dragLine;
-    bool isPluginEditorOpen = false;
+    std::string xChannel, yChannel;
+    ValueTree widgetData;
+    float xMin, xMax, yMin, yMax;
+
+    enum State
+    {
+        stopped = 0,
+        starting,
+        moving
+    };
+
+    //written on the message thread, consumed by the audio thread
+    std::atomic<int> state { stopped };
+    std::atomic<float> startX { 0 }, startY { 0 };
+    std::atomic<float> startXVelocity { 0 }, startYVelocity { 0 };
+
+    //only touched by the audio thread
+    double xValue = 0, yValue = 0;
+    double xVelocity = 0, yVelocity = 0;
+
+    //written by the audio thread, read on the message thread
+    std::atomic<float> currentX { 0 }, currentY { 0 };
+    std::atomic<bool> positionChanged { false };
+
     bool repaintBackground = false;
-    juce::Point<double> position;
-    float xMin, xMax, yMin, yMax, velocity;
-    CabbagePluginProcessor* owner;
 
 public:
-    XYPadAutomator (String name, CabbagePluginParameter* xParam, CabbagePluginParameter* yParam, CabbagePluginProcessor* _owner);
+    XYPadAutomator (String name, CabbagePluginParameter* xParam, CabbagePluginParameter* yParam, const ValueTree& wData);
 
     ~XYPadAutomator() override
     {
-        stopTimer();
         removeAllChangeListeners();
     }
 
-    void timerCallback() override;
-    String getName()
-    {
-        return name;
-    }
-    void setDragLine (const Line<float>& newDragLine)
-    {
-        this->dragLine = newDragLine;
-    }
-    void setIsPluginEditorOpen (bool isEditorOpen)
+    //message thread
+    void start (const Line<float>& dragLine);
+    void stop();
+    void updateHostAndListeners (bool isPluginEditorOpen);
+
+    //audio thread, returns true if the channel values have moved
+    bool process (int numSamples, double sampleRate);
+
+    const char* getXChannel() const         {   return xChannel.c_str();    }
+    const char* getYChannel() const         {   return yChannel.c_str();    }
+    float getXChannelValue() const          {   return (float) xValue;  }
+    float getYChannelValue() const          {   return yMin + (yMax - (float) yValue);  }
+
+    bool isRunning() const
     {
-        this->isPluginEditorOpen = isEditorOpen;
+        return state.load() != stopped;
     }
-    void setName (const String& newName)
+    String getName()
     {
-        this->name = newName;
+        return name;
     }
-    void setPosition (const juce::Point<double>& newPosition)
+    juce::Point<double> getPosition() const
     {
-        this->position = newPosition;
+        return { (double) currentX.load(), (double) currentY.load() };
     }
     void setRepaintBackground (bool paintBackground)
     {
         this->repaintBackground = paintBackground;
     }
-    void setVelocity (float newVelocity)
-    {
-        this->velocity = newVelocity;
-    }
-    void setXMax (float newXMax)
-    {
-        this->xMax = newXMax;
-    }
-    void setXMin (float newXMin)
-    {
-        this->xMin = newXMin;
-    }
-    void setXValue (float newXValue)
-    {
-        this->xValue = newXValue;
-    }
-    void setXValueIncrement (float newXValueIncrement)
-    {
-        this->xValueIncrement = newXValueIncrement;
-    }
-    void setYMax (float newYMax)
-    {
-        this->yMax = newYMax;
-    }
-    void setYMin (float newYMin)
-    {
-        this->yMin = newYMin;
-    }
-    void setYValue (float newYValue)
-    {
-        this->yValue = newYValue;
-    }
-    void setYValueIncrement (float newYValueIncrement)
-    {
-        this->yValueIncrement = newYValueIncrement;
-    }
-    bool getIsPluginEditorOpen() const
-    {
-        return isPluginEditorOpen;
-    }
-    const juce::Point<double>& getPosition() const
-    {
-        return position;
-    }
     bool getShouldRepaintBackground() const
     {
         return repaintBackground;
     }
-    float getXValueIncrement() const
-    {
-        return xValueIncrement;
-    }
 
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XYPadAutomator)
 };
 
 #endif  // CABBAGEXYPAD_H_INCLUDED
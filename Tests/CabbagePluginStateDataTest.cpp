@@ -0,0 +1,112 @@
+/*
+  Copyright (C) 2016 Rory Walsh
+
+  Cabbage is free software; you can redistribute it
+  and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  Cabbage is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with Csound; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+  02111-1307 USA
+*/
+
+
+#include "JuceHeader.h"
+#include "../Source/Audio/Plugins/CabbagePluginStateData.h"
+
+//==============================================================================
+// Checks that plugin state survives a trip through the binary session format,
+// that JSON text saved by older versions still loads, and that corrupt blobs
+// are rejected rather than read.
+//==============================================================================
+class CabbagePluginStateDataTest : public UnitTest
+{
+public:
+    CabbagePluginStateDataTest() : UnitTest ("CabbagePluginStateData", "Cabbage") {}
+
+    void runTest() override
+    {
+        beginTest ("Binary round trip");
+        {
+            nlohmann::ordered_json state;
+            state["gain"] = 0.5f;
+            state["cutoff"] = 1234.567891234;
+            state["mode"] = 3;
+            state["bypass"] = true;
+            state["filename"] = "sample.wav";
+            state["stateData"] = std::string (4096, 'x');
+            state["presets"] = nlohmann::ordered_json::array ({ 1, 2.5, "three", nullptr });
+            state["nested"]["gain"] = 0.25f;
+
+            MemoryBlock data;
+            CabbagePluginStateData::write (state, data);
+            expect (CabbagePluginStateData::isBinaryState (data.getData(), (int) data.getSize()));
+
+            nlohmann::ordered_json restored;
+            expect (CabbagePluginStateData::readState (data.getData(), (int) data.getSize(), restored));
+            expect (restored == state);
+            expect (restored.begin().key() == "gain");
+        }
+
+        beginTest ("Legacy JSON state");
+        {
+            const String legacy ("{\"gain\":0.5,\"mode\":3,\"filename\":\"sample.wav\",\"stateData\":\"{}\"}");
+
+            nlohmann::ordered_json restored;
+            expect (! CabbagePluginStateData::isBinaryState (legacy.toRawUTF8(), (int) legacy.getNumBytesAsUTF8()));
+            expect (CabbagePluginStateData::readState (legacy.toRawUTF8(), (int) legacy.getNumBytesAsUTF8(), restored));
+            expectEquals (restored["gain"].get<double>(), 0.5);
+            expectEquals (restored["mode"].get<int>(), 3);
+            expect (restored["filename"] == "sample.wav");
+        }
+
+        beginTest ("Corrupt state");
+        {
+            nlohmann::ordered_json state;
+            state["stateData"] = std::string (4096, 'x');
+
+            MemoryBlock data;
+            CabbagePluginStateData::write (state, data);
+
+            nlohmann::ordered_json restored;
+            MemoryBlock truncated (data.getData(), data.getSize() / 2);
+            expect (! CabbagePluginStateData::read (truncated.getData(), (int) truncated.getSize(), restored));
+
+            //claim a huge original size for a tiny compressed string
+            MemoryBlock oversized;
+            {
+                MemoryOutputStream out (oversized, false);
+                out.writeInt (CabbagePluginStateData::magicNumber);
+                out.writeInt (CabbagePluginStateData::currentVersion);
+                out.writeCompressedInt (0);
+                out.writeByte ((char) CabbagePluginStateData::compressedStringValue);
+                out.writeCompressedInt (0x7fffffff);
+                out.writeCompressedInt (4);
+                out.writeInt (0);
+            }
+            expect (! CabbagePluginStateData::read (oversized.getData(), (int) oversized.getSize(), restored));
+        }
+    }
+};
+
+static CabbagePluginStateDataTest cabbagePluginStateDataTest;
+
+int main()
+{
+    UnitTestRunner runner;
+    runner.setAssertOnFailure (false);
+    runner.runTestsInCategory ("Cabbage");
+
+    for (int i = 0; i < runner.getNumResults(); i++)
+        if (runner.getResult (i)->failures > 0)
+            return 1;
+
+    return 0;
+}